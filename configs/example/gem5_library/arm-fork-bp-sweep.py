@@ -0,0 +1,105 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+This gem5 configuation script sweeps the branch predictor of an O3 core
+running an ARM "hello world" binary. The system is instantiated once, and
+the simulator is then forked once per branch predictor. Each child switches
+from the atomic core to the O3 core using its predictor and runs the
+workload.
+
+The statistics of each variant are written to `m5out/<predictor>/stats.txt`.
+The same flow applies when restoring a checkpoint, which is then only
+restored once for the whole sweep.
+
+Usage
+-----
+
+```
+scons build/ARM/gem5.opt
+./build/ARM/gem5.opt configs/example/gem5_library/arm-fork-bp-sweep.py
+```
+"""
+
+from gem5.isas import ISA
+from gem5.utils.requires import requires
+from gem5.resources.resource import Resource
+from gem5.components.memory import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.cachehierarchies.classic.private_l1_cache_hierarchy \
+    import PrivateL1CacheHierarchy
+from gem5.components.processors.simple_core import SimpleCore
+from gem5.components.processors.switchable_processor import (
+    SwitchableProcessor,
+)
+from gem5.simulate.simulator import Simulator
+
+from m5.objects import BiModeBP, LTAGE, TournamentBP
+
+requires(isa_required=ISA.ARM)
+
+predictors = {
+    "bimode": BiModeBP,
+    "tournament": TournamentBP,
+    "ltage": LTAGE,
+}
+
+# One O3 core per predictor. Only the one of the variant is switched in.
+cores = {"atomic": [SimpleCore(CPUTypes.ATOMIC, core_id=0, isa=ISA.ARM)]}
+for name, predictor in predictors.items():
+    core = SimpleCore(CPUTypes.O3, core_id=0, isa=ISA.ARM)
+    core.get_simobject().branchPred = predictor()
+    cores[name] = [core]
+
+processor = SwitchableProcessor(
+    switchable_cores=cores, starting_cores="atomic"
+)
+
+board = SimpleBoard(
+    clk_freq="3GHz",
+    processor=processor,
+    memory=SingleChannelDDR3_1600(size="32MB"),
+    cache_hierarchy=PrivateL1CacheHierarchy(l1d_size="32kB", l1i_size="32kB"),
+)
+
+board.set_se_binary_workload(Resource("arm-hello64-static"))
+
+simulator = Simulator(board=board)
+
+
+def run_with(predictor: str):
+    def configure(simulator: Simulator) -> None:
+        processor.switch_to_processor(predictor)
+
+    return configure
+
+
+exit_codes = simulator.fork_variants(
+    {name: run_with(name) for name in predictors}
+)
+
+for name, code in exit_codes.items():
+    print(f"Variant '{name}' exited with code {code}.")
@@ -0,0 +1,95 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+This gem5 configuation script runs an ARM "hello world" binary with
+SMARTS-style sampled simulation. Atomic cores keep the caches and the branch
+predictor warm between samples, and O3 cores are switched in to warm up and
+measure each sample.
+
+The per-sample IPC and its confidence interval are written to
+`m5out/sampling.json`, and the statistics of each sample are dumped to
+`m5out/stats.txt`.
+
+Usage
+-----
+
+```
+scons build/ARM/gem5.opt
+./build/ARM/gem5.opt configs/example/gem5_library/arm-sampled-hello.py
+```
+"""
+
+from gem5.isas import ISA
+from gem5.utils.requires import requires
+from gem5.resources.resource import Resource
+from gem5.components.memory import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.cachehierarchies.classic.private_l1_cache_hierarchy \
+    import PrivateL1CacheHierarchy
+from gem5.components.processors.sampling_processor import SamplingProcessor
+from gem5.simulate.sampling import SampledSimulator
+
+requires(isa_required=ISA.ARM)
+
+# The caches are shared by the atomic and the O3 cores, which keeps them warm
+# during functional warming.
+cache_hierarchy = PrivateL1CacheHierarchy(l1d_size="32kB", l1i_size="32kB")
+
+memory = SingleChannelDDR3_1600(size="32MB")
+
+processor = SamplingProcessor(
+    detailed_core_type=CPUTypes.O3, isa=ISA.ARM, num_cores=1
+)
+
+board = SimpleBoard(
+    clk_freq="3GHz",
+    processor=processor,
+    memory=memory,
+    cache_hierarchy=cache_hierarchy,
+)
+
+board.set_se_binary_workload(Resource("arm-hello64-static"))
+
+# The hello world binary is short, so the intervals are much shorter than
+# what would be used for real workloads (e.g., 1000 instructions measured
+# every million instructions).
+simulator = SampledSimulator(
+    board=board,
+    functional_warming_insts=400,
+    detailed_warmup_insts=200,
+    measurement_insts=100,
+)
+simulator.run()
+
+print(
+    "Exiting @ tick {} because {}.".format(
+        simulator.get_current_tick(),
+        simulator.get_last_exit_event_cause(),
+    )
+)
+print("Sampled IPC estimate: {}".format(simulator.get_ipc_estimate()))
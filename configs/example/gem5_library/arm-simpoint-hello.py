@@ -0,0 +1,78 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+"""
+This gem5 configuation script runs the whole SimPoint flow on an ARM "hello
+world" binary: the workload is profiled on an atomic core, the SimPoints are
+selected, checkpoints are taken before them, and each SimPoint is simulated
+on an O3 core in parallel. The statistics of the SimPoints, weighted, are
+written to `m5out/stats.txt`, and the output of every step is in
+`m5out/simpoint`.
+
+Usage
+-----
+
+```
+scons build/ARM/gem5.opt
+./build/ARM/gem5.opt configs/example/gem5_library/arm-simpoint-hello.py
+```
+"""
+
+from gem5.isas import ISA
+from gem5.utils.requires import requires
+from gem5.resources.resource import Resource
+from gem5.components.memory import SingleChannelDDR3_1600
+from gem5.components.processors.cpu_types import CPUTypes
+from gem5.components.boards.simple_board import SimpleBoard
+from gem5.components.cachehierarchies.classic.private_l1_cache_hierarchy \
+    import PrivateL1CacheHierarchy
+from gem5.components.processors.simple_processor import SimpleProcessor
+from gem5.simulate.simpoint_pipeline import SimPointPipeline
+
+requires(isa_required=ISA.ARM)
+
+
+def build_board(cpu_type: CPUTypes) -> SimpleBoard:
+    board = SimpleBoard(
+        clk_freq="3GHz",
+        processor=SimpleProcessor(cpu_type=cpu_type, isa=ISA.ARM, num_cores=1),
+        memory=SingleChannelDDR3_1600(size="32MB"),
+        cache_hierarchy=PrivateL1CacheHierarchy(
+            l1d_size="32kB", l1i_size="32kB"
+        ),
+    )
+    board.set_se_binary_workload(Resource("arm-hello64-static"))
+    return board
+
+
+# The hello world binary is short, so the intervals are much shorter than
+# what would be used for real workloads (e.g., 10 million instructions).
+SimPointPipeline(
+    build_board=build_board,
+    detailed_cpu_type=CPUTypes.O3,
+    interval_insts=1000,
+    warmup_insts=200,
+    max_clusters=4,
+).run()
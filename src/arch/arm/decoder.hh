@@ -148,6 +148,8 @@ class Decoder : public InstDecoder
     void
     setContext(FPSCR fpscr)
     {
+        if (fpscrLen != fpscr.len || fpscrStride != fpscr.stride)
+            contextChanged();
         fpscrLen = fpscr.len;
         fpscrStride = fpscr.stride;
     }
@@ -155,6 +157,8 @@ class Decoder : public InstDecoder
     void
     setSveLen(uint8_t len)
     {
+        if (sveLen != len)
+            contextChanged();
         sveLen = len;
     }
 };
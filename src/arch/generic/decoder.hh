@@ -49,6 +49,16 @@ class InstDecoder : public SimObject
     bool instDone = false;
     bool outOfBytes = true;
 
+    /** Incremented whenever the decoding context changes. */
+    uint64_t _contextGen = 0;
+
+    /**
+     * Signal a change of the state used to interpret the instructions
+     * (e.g. the operating mode), which makes any instruction decoded
+     * before it potentially stale.
+     */
+    void contextChanged() { _contextGen++; }
+
   public:
     template <typename MoreBytesType>
     InstDecoder(const InstDecoderParams &params, MoreBytesType *mb_buf) :
@@ -96,6 +106,12 @@ class InstDecoder : public SimObject
     size_t moreBytesSize() const { return _moreBytesSize; }
     Addr pcMask() const { return _pcMask; }
 
+    /**
+     * Generation of the decoding context. CPU models keeping decoded
+     * instructions around must drop them when it changes.
+     */
+    uint64_t contextGen() const { return _contextGen; }
+
     /**
      * Is an instruction ready to be decoded?
      *
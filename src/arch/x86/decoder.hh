@@ -277,6 +277,7 @@ class Decoder : public InstDecoder
         altAddr = m5Reg.altAddr;
         defAddr = m5Reg.defAddr;
         stack = m5Reg.stack;
+        contextChanged();
 
         AddrCacheMap::iterator amIter = addrCacheMap.find(m5Reg);
         if (amIter != addrCacheMap.end()) {
@@ -0,0 +1,457 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/mapped_inifile.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const char IndexMagic[8] = "gem5cpi";
+constexpr uint32_t IndexVersion = 1;
+
+struct IndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numSections;
+    uint64_t numEntries;
+    /** Size and modification time (ns) of the indexed file. */
+    uint64_t fileSize;
+    int64_t fileModTime;
+};
+
+struct IndexSection
+{
+    uint64_t nameOffset;
+    uint32_t nameSize;
+    uint32_t numEntries;
+    uint64_t firstEntry;
+};
+
+struct IndexEntry
+{
+    uint64_t keyOffset;
+    uint64_t valueOffset;
+    uint32_t keySize;
+    uint32_t valueSize;
+};
+
+/** Map a whole file, return nullptr if it is empty. */
+bool
+mapFile(const std::string &file, const char *&data, size_t &size,
+        int64_t *mod_time=nullptr)
+{
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    size = st.st_size;
+    if (mod_time)
+        *mod_time = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+
+    data = nullptr;
+    if (size != 0) {
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        data = static_cast<const char *>(addr);
+    }
+
+    close(fd);
+    return true;
+}
+
+/** Remove the spaces around a string, like eat_white(). */
+std::string_view
+trimSpaces(std::string_view s)
+{
+    size_t begin = s.find_first_not_of(' ');
+    if (begin == std::string_view::npos)
+        return s.substr(s.size());
+    return s.substr(begin, s.find_last_not_of(' ') - begin + 1);
+}
+
+/**
+ * Call a function with each non-empty line of a range of a file, like
+ * IniFile::load() reads them: without leading whitespace and trailing
+ * spaces.
+ */
+template <typename F>
+void
+forEachLine(const char *data, size_t begin, size_t end, F f)
+{
+    size_t pos = begin;
+    while (pos < end) {
+        while (pos < end && std::isspace((unsigned char)data[pos]))
+            pos++;
+        if (pos == end)
+            break;
+
+        const void *eol = std::memchr(data + pos, '\n', end - pos);
+        size_t line_end = eol ? static_cast<const char *>(eol) - data : end;
+
+        std::string_view line(data + pos, line_end - pos);
+        size_t last = line.find_last_not_of(' ');
+        if (last != std::string_view::npos)
+            f(pos, line_end, line.substr(0, last + 1));
+
+        pos = line_end;
+    }
+}
+
+} // anonymous namespace
+
+MappedIniFile::~MappedIniFile()
+{
+    unmap();
+}
+
+void
+MappedIniFile::unmap()
+{
+    if (data)
+        munmap(const_cast<char *>(data), size);
+    if (indexData)
+        munmap(const_cast<char *>(indexData), indexSize);
+    data = indexData = nullptr;
+    size = indexSize = 0;
+    sections.clear();
+    appended.clear();
+}
+
+bool
+MappedIniFile::load(const std::string &file, bool use_index)
+{
+    unmap();
+
+    fileName = file;
+    if (!mapFile(file, data, size, &modTime))
+        return false;
+
+    if (!use_index || !loadIndex(file + IndexSuffix))
+        scan();
+
+    return true;
+}
+
+void
+MappedIniFile::scan()
+{
+    Section *current = nullptr;
+    size_t body = 0;
+
+    forEachLine(data, 0, size,
+        [&](size_t begin, size_t end, std::string_view line) {
+            if (line.front() != '[' || line.back() != ']')
+                return;
+
+            if (current)
+                current->bodies.emplace_back(body, begin);
+            current = &sections[trimSpaces(
+                    line.substr(1, line.size() - 2))];
+            body = end;
+        });
+
+    if (current)
+        current->bodies.emplace_back(body, size);
+}
+
+bool
+MappedIniFile::loadIndex(const std::string &index_file)
+{
+    if (!mapFile(index_file, indexData, indexSize))
+        return false;
+
+    auto header = reinterpret_cast<const IndexHeader *>(indexData);
+    bool valid = indexSize >= sizeof(IndexHeader) &&
+        std::memcmp(header->magic, IndexMagic, sizeof(IndexMagic)) == 0 &&
+        header->version == IndexVersion &&
+        indexSize == sizeof(IndexHeader) +
+            header->numSections * sizeof(IndexSection) +
+            header->numEntries * sizeof(IndexEntry);
+
+    if (valid && (header->fileSize != size ||
+                  header->fileModTime != modTime)) {
+        warn("Ignoring %s, it is older than the file it indexes.\n",
+             index_file);
+        valid = false;
+    }
+
+    if (valid) {
+        auto records = reinterpret_cast<const IndexSection *>(header + 1);
+        auto entries = reinterpret_cast<const IndexEntry *>(
+                records + header->numSections);
+        for (uint32_t i = 0; i < header->numSections && valid; ++i) {
+            const IndexSection &record = records[i];
+            valid = record.nameOffset + record.nameSize <= size &&
+                record.firstEntry + record.numEntries <= header->numEntries;
+            if (valid) {
+                Section &section = sections[std::string_view(
+                        data + record.nameOffset, record.nameSize)];
+                section.indexEntries = entries + record.firstEntry;
+                section.numIndexEntries = record.numEntries;
+            }
+        }
+        if (!valid)
+            warn("Ignoring corrupted index %s.\n", index_file);
+    }
+
+    if (!valid) {
+        munmap(const_cast<char *>(indexData), indexSize);
+        indexData = nullptr;
+        indexSize = 0;
+        sections.clear();
+    }
+
+    return valid;
+}
+
+void
+MappedIniFile::parse(Section &section)
+{
+    section.parsed = true;
+
+    if (section.indexEntries) {
+        auto entries =
+            static_cast<const IndexEntry *>(section.indexEntries);
+        section.entries.reserve(section.numIndexEntries);
+        for (uint32_t i = 0; i < section.numIndexEntries; ++i) {
+            const IndexEntry &e = entries[i];
+            fatal_if(e.keyOffset + e.keySize > size ||
+                     e.valueOffset + e.valueSize > size,
+                     "Corrupted index of %s.\n", fileName);
+            section.entries.push_back(Entry{
+                std::string_view(data + e.keyOffset, e.keySize),
+                std::string_view(data + e.valueOffset, e.valueSize)});
+        }
+        return;
+    }
+
+    struct Assignment
+    {
+        Entry entry;
+        bool append;
+    };
+    std::vector<Assignment> assignments;
+
+    for (const auto &body : section.bodies) {
+        forEachLine(data, body.first, body.second,
+            [&](size_t begin, size_t end, std::string_view line) {
+                size_t offset = line.find('=');
+                fatal_if(offset == std::string_view::npos,
+                         "Can't parse .ini line %s in %s.\n",
+                         std::string(line), fileName);
+
+                bool append = offset > 0 && line[offset - 1] == '+';
+                assignments.push_back(Assignment{
+                    Entry{trimSpaces(line.substr(0, offset - append)),
+                          trimSpaces(line.substr(offset + 1))},
+                    append});
+            });
+    }
+
+    // Sort the entries by key, keeping the assignments of the same key
+    // in the order of the file to apply them in that order.
+    std::stable_sort(assignments.begin(), assignments.end(),
+        [](const Assignment &a, const Assignment &b) {
+            return a.entry.key < b.entry.key;
+        });
+
+    for (size_t i = 0; i < assignments.size(); ) {
+        Entry entry = assignments[i].entry;
+        std::string *value = nullptr;
+        for (++i; i < assignments.size() &&
+                 assignments[i].entry.key == entry.key; ++i) {
+            const Assignment &next = assignments[i];
+            if (!next.append) {
+                entry.value = next.entry.value;
+                value = nullptr;
+                continue;
+            }
+
+            if (!value)
+                value = &appended.emplace_back(entry.value);
+            *value += " ";
+            *value += next.entry.value;
+            entry.value = *value;
+        }
+        section.entries.push_back(entry);
+    }
+}
+
+const MappedIniFile::Section *
+MappedIniFile::findSection(const std::string &name)
+{
+    auto it = sections.find(name);
+    if (it == sections.end())
+        return nullptr;
+
+    if (!it->second.parsed)
+        parse(it->second);
+    return &it->second;
+}
+
+const MappedIniFile::Entry *
+MappedIniFile::findEntry(const std::string &section_name,
+                         const std::string &entry_name)
+{
+    const Section *section = findSection(section_name);
+    if (!section)
+        return nullptr;
+
+    std::string_view key(entry_name);
+    auto it = std::lower_bound(
+        section->entries.begin(), section->entries.end(), key,
+        [](const Entry &e, std::string_view k) { return e.key < k; });
+    if (it == section->entries.end() || it->key != key)
+        return nullptr;
+    return &*it;
+}
+
+bool
+MappedIniFile::find(const std::string &section, const std::string &entry,
+                    std::string &value)
+{
+    const Entry *e = findEntry(section, entry);
+    if (!e)
+        return false;
+
+    value.assign(e->value);
+    return true;
+}
+
+bool
+MappedIniFile::entryExists(const std::string &section,
+                           const std::string &entry)
+{
+    return findEntry(section, entry) != nullptr;
+}
+
+bool
+MappedIniFile::sectionExists(const std::string &section)
+{
+    return sections.find(section) != sections.end();
+}
+
+void
+MappedIniFile::visitSection(const std::string &section_name,
+                            VisitSectionCallback cb)
+{
+    const Section *section = findSection(section_name);
+    if (!section)
+        return;
+
+    for (const auto &entry : section->entries)
+        cb(std::string(entry.key), std::string(entry.value));
+}
+
+bool
+MappedIniFile::writeIndex(const std::string &file)
+{
+    MappedIniFile ini;
+    if (!ini.load(file, false))
+        return false;
+
+    std::vector<std::pair<std::string_view, Section *>> sorted;
+    for (auto &section : ini.sections) {
+        ini.parse(section.second);
+        sorted.emplace_back(section.first, &section.second);
+    }
+
+    // Appended values are not in the file, so they can't be indexed
+    if (!ini.appended.empty())
+        return false;
+
+    std::sort(sorted.begin(), sorted.end());
+
+    IndexHeader header;
+    std::memcpy(header.magic, IndexMagic, sizeof(IndexMagic));
+    header.version = IndexVersion;
+    header.numSections = sorted.size();
+    header.numEntries = 0;
+    header.fileSize = ini.size;
+    header.fileModTime = ini.modTime;
+
+    std::vector<IndexSection> records;
+    std::vector<IndexEntry> entries;
+    for (const auto &section : sorted) {
+        records.push_back(IndexSection{
+            uint64_t(section.first.data() - ini.data),
+            uint32_t(section.first.size()),
+            uint32_t(section.second->entries.size()),
+            entries.size()});
+        for (const auto &entry : section.second->entries) {
+            entries.push_back(IndexEntry{
+                uint64_t(entry.key.data() - ini.data),
+                uint64_t(entry.value.data() - ini.data),
+                uint32_t(entry.key.size()),
+                uint32_t(entry.value.size())});
+        }
+    }
+    header.numEntries = entries.size();
+
+    // Write a temporary file first so that a partial index is never used
+    std::string index_file = file + IndexSuffix;
+    std::string tmp_file = index_file + ".tmp";
+    std::ofstream os(tmp_file, std::ios::binary | std::ios::trunc);
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(records.data()),
+             records.size() * sizeof(IndexSection));
+    os.write(reinterpret_cast<const char *>(entries.data()),
+             entries.size() * sizeof(IndexEntry));
+    os.close();
+
+    if (!os || std::rename(tmp_file.c_str(), index_file.c_str()) != 0) {
+        std::remove(tmp_file.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace gem5
@@ -0,0 +1,156 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_MAPPED_INIFILE_HH__
+#define __BASE_MAPPED_INIFILE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/inifile.hh"
+
+namespace gem5
+{
+
+/**
+ * Read-only ".ini" file, parsed lazily and in place.
+ *
+ * Unlike IniFile, which copies every key and value into its own
+ * allocations when loading, the file is memory mapped and only scanned
+ * for section headers when loaded. The entries of a section are parsed
+ * the first time the section is looked up, and the keys and values are
+ * views of the mapped file, so large checkpoints can be loaded without
+ * allocating anything per entry. The syntax and the lookup semantics
+ * are the same as IniFile's, including "+=" entries and sections
+ * appearing several times.
+ *
+ * The load can also skip the scan and the parsing altogether with a
+ * binary index of the file (see writeIndex()), stored next to it with
+ * an IndexSuffix suffix. The index holds the offsets of all the
+ * sections and entries of the file, sorted by name, and is only used
+ * if the size and modification time of the file match the ones it
+ * recorded.
+ */
+class MappedIniFile
+{
+  public:
+    using VisitSectionCallback = IniFile::VisitSectionCallback;
+
+    static constexpr const char *IndexSuffix = ".idx";
+
+  private:
+    struct Entry
+    {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    struct Section
+    {
+        /** Byte ranges of the bodies of the section in the file. */
+        std::vector<std::pair<size_t, size_t>> bodies;
+
+        /** Entries sorted by key, once parsed. */
+        std::vector<Entry> entries;
+        bool parsed = false;
+
+        /** Entries of the section in the index, if any. */
+        const void *indexEntries = nullptr;
+        uint32_t numIndexEntries = 0;
+    };
+
+    std::string fileName;
+
+    const char *data = nullptr;
+    size_t size = 0;
+    /** Modification time of the file, in ns. */
+    int64_t modTime = 0;
+
+    const char *indexData = nullptr;
+    size_t indexSize = 0;
+
+    std::unordered_map<std::string_view, Section> sections;
+
+    /** Values concatenated by "+=" entries. */
+    std::deque<std::string> appended;
+
+    /** Find the sections of the file by scanning it. */
+    void scan();
+
+    /** Use the index of the file if it is valid. */
+    bool loadIndex(const std::string &index_file);
+
+    void parse(Section &section);
+    const Section *findSection(const std::string &section);
+    const Entry *findEntry(const std::string &section,
+                           const std::string &entry);
+
+    void unmap();
+
+  public:
+    MappedIniFile() = default;
+    ~MappedIniFile();
+
+    MappedIniFile(const MappedIniFile &) = delete;
+    MappedIniFile &operator=(const MappedIniFile &) = delete;
+
+    /**
+     * Map and index a file.
+     *
+     * @param file The path of the file.
+     * @param use_index Use the binary index of the file if it exists.
+     * @return True if successful, false if the file can't be read.
+     */
+    bool load(const std::string &file, bool use_index=true);
+
+    /// Find value corresponding to given section and entry names.
+    /// @retval True if found, false if not.
+    bool find(const std::string &section, const std::string &entry,
+              std::string &value);
+
+    bool entryExists(const std::string &section, const std::string &entry);
+    bool sectionExists(const std::string &section);
+
+    /// Iterate over key/value pairs of the given section.
+    void visitSection(const std::string &section, VisitSectionCallback cb);
+
+    /**
+     * Write the binary index of a file next to it.
+     *
+     * @return False if the file can't be read or indexed (files with
+     * "+=" entries can't), or the index can't be written.
+     */
+    static bool writeIndex(const std::string &file);
+};
+
+} // namespace gem5
+
+#endif // __BASE_MAPPED_INIFILE_HH__
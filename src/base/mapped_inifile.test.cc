@@ -0,0 +1,201 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/inifile.hh"
+#include "base/mapped_inifile.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const char *iniContents = R"ini_file(## header comment
+[General]
+   Test1=BARasdf
+   Test2=bar
+
+[Junk]
+Test3=yo
+Test4=mama
+
+[Foo]
+Foo1=89
+Foo2 = 384  
+Empty=
+
+[General]
+Test3=89
+
+[Junk]
+Test4+=mia
+)ini_file";
+
+class MappedIniFileTest : public testing::Test
+{
+  protected:
+    std::string file;
+
+    void
+    SetUp() override
+    {
+        file = testing::TempDir() + "/mapped_inifile_test.ini";
+        write(iniContents);
+        std::remove((file + MappedIniFile::IndexSuffix).c_str());
+    }
+
+    void
+    TearDown() override
+    {
+        std::remove(file.c_str());
+        std::remove((file + MappedIniFile::IndexSuffix).c_str());
+    }
+
+    void
+    write(const std::string &contents)
+    {
+        std::ofstream os(file, std::ios::trunc);
+        os << contents;
+    }
+
+    /** Check that all the lookups match the ones of IniFile. */
+    void
+    checkAgainstIniFile(MappedIniFile &mapped)
+    {
+        IniFile ini;
+        std::istringstream is(iniContents);
+        ASSERT_TRUE(ini.load(is));
+
+        for (const char *section : {"General", "Junk", "Foo", "Bar"}) {
+            EXPECT_EQ(mapped.sectionExists(section),
+                      ini.sectionExists(section));
+            for (const char *entry : {"Test1", "Test2", "Test3", "Test4",
+                                      "Foo1", "Foo2", "Empty", "Foo3"}) {
+                std::string expected, actual;
+                bool found = ini.find(section, entry, expected);
+                EXPECT_EQ(mapped.find(section, entry, actual), found);
+                EXPECT_EQ(actual, expected);
+                EXPECT_EQ(mapped.entryExists(section, entry), found);
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(MappedIniFileTest, MatchesIniFile)
+{
+    MappedIniFile mapped;
+    ASSERT_TRUE(mapped.load(file));
+    checkAgainstIniFile(mapped);
+
+    std::string value;
+    ASSERT_TRUE(mapped.find("Junk", "Test4", value));
+    EXPECT_EQ(value, "mama mia");
+    ASSERT_TRUE(mapped.find("Foo", "Foo2", value));
+    EXPECT_EQ(value, "384");
+}
+
+TEST_F(MappedIniFileTest, MissingFile)
+{
+    MappedIniFile mapped;
+    EXPECT_FALSE(mapped.load(file + ".missing"));
+}
+
+TEST_F(MappedIniFileTest, VisitSection)
+{
+    MappedIniFile mapped;
+    ASSERT_TRUE(mapped.load(file));
+
+    std::vector<std::string> entries;
+    mapped.visitSection("General",
+        [&entries](const std::string &key, const std::string &value) {
+            entries.push_back(key + "=" + value);
+        });
+    EXPECT_EQ(entries, std::vector<std::string>(
+                {"Test1=BARasdf", "Test2=bar", "Test3=89"}));
+}
+
+/** Files with appended entries can't be indexed. */
+TEST_F(MappedIniFileTest, NoIndexWithAppend)
+{
+    EXPECT_FALSE(MappedIniFile::writeIndex(file));
+}
+
+TEST_F(MappedIniFileTest, Index)
+{
+    std::string contents = iniContents;
+    contents = contents.substr(0, contents.find("[Junk]\nTest4+="));
+    write(contents);
+    ASSERT_TRUE(MappedIniFile::writeIndex(file));
+
+    MappedIniFile mapped;
+    ASSERT_TRUE(mapped.load(file));
+    std::string value;
+    ASSERT_TRUE(mapped.find("Foo", "Foo2", value));
+    EXPECT_EQ(value, "384");
+    ASSERT_TRUE(mapped.find("General", "Test3", value));
+    EXPECT_EQ(value, "89");
+    EXPECT_FALSE(mapped.find("General", "Test4", value));
+    EXPECT_TRUE(mapped.sectionExists("Junk"));
+
+    MappedIniFile unindexed;
+    ASSERT_TRUE(unindexed.load(file, false));
+    for (const char *section : {"General", "Junk", "Foo"}) {
+        std::vector<std::string> expected, actual;
+        unindexed.visitSection(section,
+            [&](const std::string &k, const std::string &v) {
+                expected.push_back(k + "=" + v);
+            });
+        mapped.visitSection(section,
+            [&](const std::string &k, const std::string &v) {
+                actual.push_back(k + "=" + v);
+            });
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+/** An index older than its file is ignored. */
+TEST_F(MappedIniFileTest, StaleIndex)
+{
+    write("[A]\nx=1\n");
+    ASSERT_TRUE(MappedIniFile::writeIndex(file));
+    write("[A]\nx=2\n");
+
+    MappedIniFile mapped;
+    ASSERT_TRUE(mapped.load(file));
+    std::string value;
+    ASSERT_TRUE(mapped.find("A", "x", value));
+    EXPECT_EQ(value, "2");
+}
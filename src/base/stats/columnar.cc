@@ -0,0 +1,594 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+namespace
+{
+
+const char Magic[8] = "gem5cst";
+
+/** Name of an element of a vector, its index if it has no subname. */
+std::string
+subname(const std::vector<std::string> &subnames, size_t i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+std::vector<std::string>
+distSubnames(const DistData &data, const std::string &prefix="")
+{
+    static const char *fields[Columnar::DistFields] = {
+        "samples", "sum", "squares", "logs", "min_value", "max_value",
+        "underflow", "overflow", "min", "max", "bucket_size", "buckets",
+    };
+
+    // The last field is the number of buckets
+    std::vector<std::string> names;
+    for (size_t i = 0; i < Columnar::DistFields; ++i)
+        names.push_back(prefix + fields[i]);
+    for (size_t i = 0; i < data.cvec.size(); ++i)
+        names.push_back(prefix + "bucket" + std::to_string(i));
+    return names;
+}
+
+void
+flattenDist(const DistData &data, std::vector<double> &values)
+{
+    values.insert(values.end(), {
+        data.samples, data.sum, data.squares, data.logs,
+        data.min_val, data.max_val, data.underflow, data.overflow,
+        data.min, data.max, data.bucket_size, (double)data.cvec.size(),
+    });
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+} // anonymous namespace
+
+Columnar::Columnar(std::ostream &stream)
+{
+    open(stream);
+}
+
+Columnar::Columnar(const std::string &file)
+{
+    open(file);
+}
+
+Columnar::~Columnar()
+{
+    if (myStream)
+        delete stream;
+}
+
+void
+Columnar::open(std::ostream &_stream)
+{
+    panic_if(stream, "stream already set!");
+
+    myStream = false;
+    stream = &_stream;
+    fatal_if(!valid(), "Unable to open output stream for writing\n");
+}
+
+void
+Columnar::open(const std::string &file)
+{
+    panic_if(stream, "stream already set!");
+
+    myStream = true;
+    stream = new std::ofstream(file.c_str(),
+                               std::ios::trunc | std::ios::binary);
+    fatal_if(!valid(), "Unable to open statistics file for writing\n");
+}
+
+bool
+Columnar::valid() const
+{
+    return stream != nullptr && stream->good();
+}
+
+void
+Columnar::begin()
+{
+    writeHeader();
+
+    numVisited = 0;
+    schemaChanged = false;
+    row.clear();
+}
+
+void
+Columnar::end()
+{
+    // A dump of fewer stats than the schema also needs a new one
+    if (!schemaChanged && numVisited != schema.size()) {
+        schemaChanged = true;
+        pending.assign(schema.begin(), schema.begin() + numVisited);
+    }
+
+    if (schemaChanged || schemaId == 0) {
+        writeSchema(std::move(pending));
+        pending.clear();
+    }
+
+    writeRow(curTick(), row.data(), row.size());
+    flush();
+}
+
+std::string
+Columnar::statName(const std::string &name) const
+{
+    if (path.empty())
+        return name;
+    return csprintf("%s.%s", path.back(), name);
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push_back(name);
+    else
+        path.push_back(csprintf("%s.%s", path.back(), name));
+}
+
+void
+Columnar::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+template <typename SubnamesFn>
+void
+Columnar::addStat(const Info &info, Kind kind, const double *values,
+                  size_t size, SubnamesFn subnames)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    row.insert(row.end(), values, values + size);
+
+    // Fast path: the stats are visited in the same order at every dump,
+    // so checking the identity of each stat against the schema is enough.
+    if (!schemaChanged) {
+        if (numVisited < schema.size() &&
+            schema[numVisited].info == &info &&
+            schema[numVisited].size == size) {
+            numVisited++;
+            return;
+        }
+
+        schemaChanged = true;
+        pending.assign(schema.begin(), schema.begin() + numVisited);
+    }
+
+    pending.push_back(
+        Column{&info, kind, size, statName(info.name), subnames()});
+    numVisited++;
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    double value = info.result();
+    addStat(info, ScalarKind, &value, 1,
+            []() { return std::vector<std::string>(); });
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    const VResult &values = info.result();
+    addStat(info, VectorKind, values.data(), values.size(),
+            [&]() {
+                std::vector<std::string> names;
+                for (size_t i = 0; i < values.size(); ++i)
+                    names.push_back(subname(info.subnames, i));
+                return names;
+            });
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    addStat(info, Vector2dKind, info.cvec.data(), info.cvec.size(),
+            [&]() {
+                std::vector<std::string> names;
+                for (size_t i = 0; i < info.x; ++i) {
+                    for (size_t j = 0; j < info.y; ++j) {
+                        names.push_back(subname(info.subnames, i) + "_" +
+                                        subname(info.y_subnames, j));
+                    }
+                }
+                return names;
+            });
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    const VResult &values = info.result();
+    addStat(info, FormulaKind, values.data(), values.size(),
+            [&]() {
+                std::vector<std::string> names;
+                for (size_t i = 0; i < values.size(); ++i)
+                    names.push_back(subname(info.subnames, i));
+                return names;
+            });
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    scratch.clear();
+    flattenDist(info.data, scratch);
+    addStat(info, DistKind, scratch.data(), scratch.size(),
+            [&]() { return distSubnames(info.data); });
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    scratch.clear();
+    for (const auto &data : info.data)
+        flattenDist(data, scratch);
+    addStat(info, VectorDistKind, scratch.data(), scratch.size(),
+            [&]() {
+                std::vector<std::string> names;
+                for (size_t i = 0; i < info.data.size(); ++i) {
+                    auto dist_names = distSubnames(info.data[i],
+                            subname(info.subnames, i) + "::");
+                    names.insert(names.end(), dist_names.begin(),
+                                 dist_names.end());
+                }
+                return names;
+            });
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Columnar stat files don't support sparse histograms.\n");
+}
+
+void
+Columnar::writeHeader()
+{
+    if (!headerWritten) {
+        stream->write(Magic, sizeof(Magic));
+        writeU32(Version);
+        headerWritten = true;
+    }
+}
+
+void
+Columnar::writeSchema(std::vector<Column> columns)
+{
+    writeHeader();
+
+    schema = std::move(columns);
+    schemaId++;
+
+    writeU32(SchemaRecord);
+    writeU32(schemaId);
+    writeU32(schema.size());
+    for (const auto &column : schema) {
+        writeU32(column.kind);
+        writeU32(column.size);
+        writeString(column.name);
+        writeString(column.info->desc);
+        writeString(column.info->unit->getUnitString());
+        writeU32(column.subnames.size());
+        for (const auto &name : column.subnames)
+            writeString(name);
+    }
+}
+
+void
+Columnar::writeRow(Tick when, const double *values, size_t size)
+{
+    assert(schemaId != 0);
+
+    writeU32(RowRecord);
+    writeU32(schemaId);
+    writeU64(when);
+    writeU64(size);
+    stream->write(reinterpret_cast<const char *>(values),
+                  size * sizeof(double));
+}
+
+void
+Columnar::flush()
+{
+    stream->flush();
+}
+
+void
+Columnar::writeString(const std::string &s)
+{
+    writeU32(s.size());
+    stream->write(s.data(), s.size());
+}
+
+void
+Columnar::writeU32(uint32_t v)
+{
+    stream->write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void
+Columnar::writeU64(uint64_t v)
+{
+    stream->write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+ColumnarSnapshot::ColumnarSnapshot(std::ostream &stream, size_t _capacity)
+    : out(stream), capacity(std::max<size_t>(_capacity, 1))
+{
+}
+
+ColumnarSnapshot::~ColumnarSnapshot()
+{
+    flush();
+}
+
+bool
+ColumnarSnapshot::valid() const
+{
+    return out.valid();
+}
+
+void
+ColumnarSnapshot::begin()
+{
+    // The snapshots taken so far use the previous layout
+    flush();
+
+    columns.clear();
+    toPrepare.clear();
+    width = 0;
+    schemaWritten = false;
+}
+
+void
+ColumnarSnapshot::end()
+{
+    rows.assign(capacity * width, 0.0);
+    ticks.assign(capacity, 0);
+    numRows = 0;
+}
+
+void
+ColumnarSnapshot::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push_back(name);
+    else
+        path.push_back(csprintf("%s.%s", path.back(), name));
+}
+
+void
+ColumnarSnapshot::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+void
+ColumnarSnapshot::addColumn(const Info &info, Columnar::Kind kind,
+                            size_t size, std::vector<std::string> subnames)
+{
+    std::string name = path.empty() ? info.name :
+        csprintf("%s.%s", path.back(), info.name);
+    columns.push_back(
+        Columnar::Column{&info, kind, size, name, std::move(subnames)});
+    width += size;
+}
+
+void
+ColumnarSnapshot::visit(const ScalarInfo &info)
+{
+    if (info.flags.isSet(display))
+        addColumn(info, Columnar::ScalarKind, 1, {});
+}
+
+void
+ColumnarSnapshot::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < info.size(); ++i)
+        names.push_back(subname(info.subnames, i));
+    addColumn(info, Columnar::VectorKind, info.size(), std::move(names));
+}
+
+void
+ColumnarSnapshot::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < info.x; ++i) {
+        for (size_t j = 0; j < info.y; ++j) {
+            names.push_back(subname(info.subnames, i) + "_" +
+                            subname(info.y_subnames, j));
+        }
+    }
+    addColumn(info, Columnar::Vector2dKind, names.size(), std::move(names));
+    // The visitor interface is const, but the stats are ours to prepare
+    toPrepare.push_back(const_cast<Vector2dInfo *>(&info));
+}
+
+void
+ColumnarSnapshot::visit(const FormulaInfo &info)
+{
+}
+
+void
+ColumnarSnapshot::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    auto names = distSubnames(info.data);
+    addColumn(info, Columnar::DistKind, names.size(), std::move(names));
+    toPrepare.push_back(const_cast<DistInfo *>(&info));
+}
+
+void
+ColumnarSnapshot::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < info.data.size(); ++i) {
+        auto dist_names = distSubnames(info.data[i],
+                subname(info.subnames, i) + "::");
+        names.insert(names.end(), dist_names.begin(), dist_names.end());
+    }
+    addColumn(info, Columnar::VectorDistKind, names.size(),
+              std::move(names));
+    toPrepare.push_back(const_cast<VectorDistInfo *>(&info));
+}
+
+void
+ColumnarSnapshot::visit(const SparseHistInfo &info)
+{
+    warn_once("Stat snapshots don't support sparse histograms.\n");
+}
+
+void
+ColumnarSnapshot::take()
+{
+    if (columns.empty())
+        return;
+
+    if (numRows == capacity)
+        flush();
+
+    for (auto *info : toPrepare)
+        info->prepare();
+
+    double *row = rows.data() + numRows * width;
+    for (const auto &column : columns) {
+        switch (column.kind) {
+          case Columnar::ScalarKind:
+            *row = static_cast<const ScalarInfo *>(column.info)->value();
+            break;
+          case Columnar::VectorKind: {
+            const VCounter &values =
+                static_cast<const VectorInfo *>(column.info)->value();
+            std::copy(values.begin(), values.end(), row);
+            break;
+          }
+          case Columnar::Vector2dKind: {
+            const VCounter &values =
+                static_cast<const Vector2dInfo *>(column.info)->cvec;
+            std::copy(values.begin(), values.end(), row);
+            break;
+          }
+          case Columnar::DistKind:
+            scratch.clear();
+            flattenDist(static_cast<const DistInfo *>(column.info)->data,
+                        scratch);
+            std::copy(scratch.begin(), scratch.end(), row);
+            break;
+          case Columnar::VectorDistKind:
+            scratch.clear();
+            for (const auto &data :
+                    static_cast<const VectorDistInfo *>(column.info)->data) {
+                flattenDist(data, scratch);
+            }
+            std::copy(scratch.begin(), scratch.end(), row);
+            break;
+          default:
+            panic("Unexpected kind of stat in a snapshot.");
+        }
+        row += column.size;
+    }
+
+    ticks[numRows++] = curTick();
+}
+
+void
+ColumnarSnapshot::flush()
+{
+    if (numRows == 0)
+        return;
+
+    if (!schemaWritten) {
+        out.writeSchema(columns);
+        schemaWritten = true;
+    }
+
+    for (size_t i = 0; i < numRows; ++i)
+        out.writeRow(ticks[i], rows.data() + i * width, width);
+    out.flush();
+    numRows = 0;
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename)
+{
+    return std::make_unique<Columnar>(
+        *simout.findOrCreate(filename, true)->stream());
+}
+
+std::unique_ptr<ColumnarSnapshot>
+initColumnarSnapshot(const std::string &filename, size_t capacity)
+{
+    return std::make_unique<ColumnarSnapshot>(
+        *simout.findOrCreate(filename, true)->stream(), capacity);
+}
+
+} // namespace statistics
+} // namespace gem5
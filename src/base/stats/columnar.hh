@@ -0,0 +1,272 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+class Info;
+
+/**
+ * Binary output of the statistics as a time series.
+ *
+ * The file starts with an 8-byte magic string ("gem5cst" and a null
+ * character) and a 32-bit version, followed by records. A schema record
+ * describes the stats of a dump once, and a row record holds the values
+ * of the stats of a dump, in the order of the schema, as raw doubles. A
+ * new schema is only written when the stats of a dump differ from the
+ * previous one, e.g., for dumps of part of the hierarchy, so periodic
+ * dumps only append fixed-layout rows.
+ *
+ * All the integers and doubles are in host byte order. Strings are a
+ * 32-bit length followed by the characters.
+ *
+ * Schema record:
+ *     uint32 type (SchemaRecord), uint32 schema id, uint32 number of stats
+ *     and, for each stat: uint32 kind, uint32 number of values, string
+ *     name, string description, string unit, uint32 number of subnames
+ *     and the subnames.
+ *
+ * Row record:
+ *     uint32 type (RowRecord), uint32 schema id, uint64 tick, uint64
+ *     number of values and the values.
+ *
+ * Distributions are stored as their samples, sum, sum of squares, sum of
+ * logarithms, minimum and maximum values, underflow and overflow counts,
+ * bucket range and size, and number of buckets, followed by the bucket
+ * counts. Sparse histograms
+ * are not supported, as their number of values varies between dumps.
+ *
+ * util/columnar_stats.py reads the files into numpy arrays.
+ */
+class Columnar : public Output
+{
+  public:
+    static constexpr uint32_t Version = 1;
+
+    enum RecordType : uint32_t
+    {
+        SchemaRecord = 1,
+        RowRecord = 2,
+    };
+
+    enum Kind : uint32_t
+    {
+        ScalarKind = 0,
+        VectorKind = 1,
+        Vector2dKind = 2,
+        FormulaKind = 3,
+        DistKind = 4,
+        VectorDistKind = 5,
+    };
+
+    /** Number of values of a distribution before its buckets. */
+    static constexpr size_t DistFields = 12;
+
+    struct Column
+    {
+        const Info *info;
+        Kind kind;
+        size_t size;
+        std::string name;
+        std::vector<std::string> subnames;
+    };
+
+  private:
+    std::ostream *stream = nullptr;
+    bool myStream = false;
+    bool headerWritten = false;
+
+    /** Full names of the groups being visited. */
+    std::vector<std::string> path;
+
+    /** Stats of the last schema written. */
+    std::vector<Column> schema;
+    uint32_t schemaId = 0;
+
+    /** Stats visited in the current dump when they differ from schema. */
+    std::vector<Column> pending;
+    bool schemaChanged = false;
+
+    /** Number of stats visited in the current dump. */
+    size_t numVisited = 0;
+
+    /** Values of the current dump. */
+    std::vector<double> row;
+
+    /** Scratch space to flatten distributions. */
+    std::vector<double> scratch;
+
+    std::string statName(const std::string &name) const;
+
+    /**
+     * Append the values of a stat to the current row. The subnames are
+     * only computed when the schema changes.
+     */
+    template <typename SubnamesFn>
+    void addStat(const Info &info, Kind kind, const double *values,
+                 size_t size, SubnamesFn subnames);
+
+    void writeHeader();
+    void writeString(const std::string &s);
+    void writeU32(uint32_t v);
+    void writeU64(uint64_t v);
+
+  public:
+    Columnar() = default;
+    Columnar(std::ostream &stream);
+    Columnar(const std::string &file);
+    ~Columnar();
+
+    void open(std::ostream &stream);
+    void open(const std::string &file);
+
+    /** Write a schema record, used by all the following rows. */
+    void writeSchema(std::vector<Column> columns);
+
+    /** Write a row of values of the current schema. */
+    void writeRow(Tick when, const double *values, size_t size);
+
+    void flush();
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+};
+
+/**
+ * Cheap periodic sampling of the statistics.
+ *
+ * Visiting the stats with this output (e.g., with a regular stats dump)
+ * records their layout once. Every call to take() then copies the raw
+ * counters of the stats into a preallocated buffer of rows, without
+ * evaluating formulas, formatting anything or resetting the stats. The
+ * rows are written to a columnar stats file (see Columnar) when the
+ * buffer is full, or when flushing, and the per-interval values are
+ * computed offline as the difference between consecutive rows, e.g.,
+ * with ColumnarStats.deltas() of util/columnar_stats.py.
+ *
+ * Formulas are not recorded, as they are not counters, and neither are
+ * sparse histograms. Scalars and vectors are read directly from their
+ * storage. Other stats need to be prepared, which copies their storage.
+ */
+class ColumnarSnapshot : public Output
+{
+  private:
+    Columnar out;
+
+    /** Stats of the snapshots. */
+    std::vector<Columnar::Column> columns;
+
+    /** Number of values of a snapshot. */
+    size_t width = 0;
+
+    /** Full names of the groups being visited. */
+    std::vector<std::string> path;
+
+    /** Snapshots not written yet, capacity rows of width values. */
+    std::vector<double> rows;
+    std::vector<Tick> ticks;
+    size_t capacity;
+    size_t numRows = 0;
+
+    /** Stats that have to be prepared before reading their values. */
+    std::vector<Info *> toPrepare;
+
+    /** Scratch space to flatten distributions. */
+    std::vector<double> scratch;
+
+    bool schemaWritten = false;
+
+    void addColumn(const Info &info, Columnar::Kind kind, size_t size,
+                   std::vector<std::string> subnames);
+
+  public:
+    ColumnarSnapshot(std::ostream &stream, size_t capacity);
+    ~ColumnarSnapshot();
+
+    /** Copy the current values of the stats into the buffer. */
+    void take();
+
+    /** Write the buffered snapshots to the file. */
+    void flush();
+
+    size_t size() const { return columns.size(); }
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+};
+
+std::unique_ptr<Output> initColumnar(const std::string &filename);
+
+std::unique_ptr<ColumnarSnapshot>
+initColumnarSnapshot(const std::string &filename, size_t capacity);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_COLUMNAR_HH__
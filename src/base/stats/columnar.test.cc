@@ -0,0 +1,303 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/stats/columnar.hh"
+#include "base/stats/info.hh"
+
+using namespace gem5;
+
+// Instantiate the fake class to have a valid curTick of 0
+GTestTickHandler tickHandler;
+
+namespace
+{
+
+class TestScalarInfo : public statistics::ScalarInfo
+{
+  public:
+    double val = 0;
+
+    TestScalarInfo(const std::string &_name)
+    {
+        setName(_name, false);
+        flags = statistics::display;
+    }
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override { val = 0; }
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+};
+
+class TestVectorInfo : public statistics::VectorInfo
+{
+  public:
+    statistics::VCounter vals;
+    mutable statistics::VResult results;
+
+    TestVectorInfo(const std::string &_name, size_t size)
+        : vals(size, 0)
+    {
+        setName(_name, false);
+        flags = statistics::display;
+    }
+
+    statistics::size_type size() const override { return vals.size(); }
+    const statistics::VCounter &value() const override { return vals; }
+
+    const statistics::VResult &
+    result() const override
+    {
+        results.assign(vals.begin(), vals.end());
+        return results;
+    }
+
+    statistics::Result total() const override { return 0; }
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+};
+
+/** Sequential reader of the records of a columnar stats file. */
+class Reader
+{
+  private:
+    std::string data;
+    size_t pos = 0;
+
+  public:
+    Reader(const std::string &_data) : data(_data) {}
+
+    bool done() const { return pos == data.size(); }
+
+    template <typename T>
+    T
+    read()
+    {
+        T v;
+        std::memcpy(&v, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+    std::string
+    readString()
+    {
+        uint32_t len = read<uint32_t>();
+        std::string s = data.substr(pos, len);
+        pos += len;
+        return s;
+    }
+
+    std::string
+    readMagic()
+    {
+        std::string s = data.substr(pos, 8);
+        pos += 8;
+        return s;
+    }
+};
+
+void
+dump(statistics::Output &out, std::vector<statistics::Info *> stats)
+{
+    out.begin();
+    out.beginGroup("system");
+    for (auto stat : stats)
+        stat->visit(out);
+    out.endGroup();
+    out.end();
+}
+
+} // anonymous namespace
+
+/** The schema is written once, then one row per dump. */
+TEST(StatsColumnarTest, SchemaThenRows)
+{
+    std::ostringstream os;
+    statistics::Columnar out(os);
+
+    TestScalarInfo scalar("insts");
+    TestVectorInfo vector("misses", 2);
+    vector.subnames = {"read", ""};
+    scalar.desc = "Number of instructions";
+
+    scalar.val = 1;
+    vector.vals = {2, 3};
+    dump(out, {&scalar, &vector});
+    tickHandler.setCurTick(1000);
+    scalar.val = 4;
+    vector.vals = {5, 6};
+    dump(out, {&scalar, &vector});
+
+    Reader r(os.str());
+    EXPECT_EQ(r.readMagic(), std::string("gem5cst", 8));
+    EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::Version);
+
+    EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::SchemaRecord);
+    EXPECT_EQ(r.read<uint32_t>(), 1);
+    EXPECT_EQ(r.read<uint32_t>(), 2);
+
+    EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::ScalarKind);
+    EXPECT_EQ(r.read<uint32_t>(), 1);
+    EXPECT_EQ(r.readString(), "system.insts");
+    EXPECT_EQ(r.readString(), "Number of instructions");
+    r.readString();
+    EXPECT_EQ(r.read<uint32_t>(), 0);
+
+    EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::VectorKind);
+    EXPECT_EQ(r.read<uint32_t>(), 2);
+    EXPECT_EQ(r.readString(), "system.misses");
+    r.readString();
+    r.readString();
+    EXPECT_EQ(r.read<uint32_t>(), 2);
+    EXPECT_EQ(r.readString(), "read");
+    EXPECT_EQ(r.readString(), "1");
+
+    for (double first : {1.0, 4.0}) {
+        EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::RowRecord);
+        EXPECT_EQ(r.read<uint32_t>(), 1);
+        EXPECT_EQ(r.read<uint64_t>(), first == 1.0 ? 0 : 1000);
+        EXPECT_EQ(r.read<uint64_t>(), 3);
+        EXPECT_EQ(r.read<double>(), first);
+        EXPECT_EQ(r.read<double>(), first + 1);
+        EXPECT_EQ(r.read<double>(), first + 2);
+    }
+
+    EXPECT_TRUE(r.done());
+}
+
+/** Dumping different stats writes a new schema. */
+TEST(StatsColumnarTest, SchemaChange)
+{
+    std::ostringstream os;
+    statistics::Columnar out(os);
+
+    TestScalarInfo a("a");
+    TestScalarInfo b("b");
+    dump(out, {&a, &b});
+    dump(out, {&a});
+    dump(out, {&a});
+
+    Reader r(os.str());
+    r.readMagic();
+    r.read<uint32_t>();
+
+    auto skip_schema = [&r](uint32_t id, uint32_t num_stats) {
+        EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::SchemaRecord);
+        EXPECT_EQ(r.read<uint32_t>(), id);
+        EXPECT_EQ(r.read<uint32_t>(), num_stats);
+        for (uint32_t i = 0; i < num_stats; ++i) {
+            r.read<uint32_t>();
+            r.read<uint32_t>();
+            r.readString();
+            r.readString();
+            r.readString();
+            uint32_t num_subnames = r.read<uint32_t>();
+            for (uint32_t j = 0; j < num_subnames; ++j)
+                r.readString();
+        }
+    };
+
+    auto skip_row = [&r](uint32_t id, uint64_t num_values) {
+        EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::RowRecord);
+        EXPECT_EQ(r.read<uint32_t>(), id);
+        r.read<uint64_t>();
+        EXPECT_EQ(r.read<uint64_t>(), num_values);
+        for (uint64_t i = 0; i < num_values; ++i)
+            r.read<double>();
+    };
+
+    skip_schema(1, 2);
+    skip_row(1, 2);
+    skip_schema(2, 1);
+    skip_row(2, 1);
+    skip_row(2, 1);
+    EXPECT_TRUE(r.done());
+}
+
+/** Snapshots are buffered and written as rows of a single schema. */
+TEST(StatsColumnarTest, Snapshot)
+{
+    std::ostringstream os;
+    statistics::ColumnarSnapshot snapshot(os, 2);
+
+    TestScalarInfo scalar("insts");
+    TestVectorInfo vector("misses", 2);
+    dump(snapshot, {&scalar, &vector});
+    EXPECT_EQ(snapshot.size(), 2);
+
+    for (int i = 0; i < 3; ++i) {
+        tickHandler.setCurTick(100 * i);
+        scalar.val = i;
+        vector.vals = {10.0 * i, 20.0 * i};
+        snapshot.take();
+        // Nothing is written until the buffer is full
+        EXPECT_EQ(os.str().empty(), i < 2);
+    }
+    snapshot.flush();
+
+    Reader r(os.str());
+    r.readMagic();
+    r.read<uint32_t>();
+    EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::SchemaRecord);
+    EXPECT_EQ(r.read<uint32_t>(), 1);
+    EXPECT_EQ(r.read<uint32_t>(), 2);
+    for (int i = 0; i < 2; ++i) {
+        r.read<uint32_t>();
+        r.read<uint32_t>();
+        r.readString();
+        r.readString();
+        r.readString();
+        uint32_t num_subnames = r.read<uint32_t>();
+        for (uint32_t j = 0; j < num_subnames; ++j)
+            r.readString();
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(r.read<uint32_t>(), statistics::Columnar::RowRecord);
+        EXPECT_EQ(r.read<uint32_t>(), 1);
+        EXPECT_EQ(r.read<uint64_t>(), 100 * i);
+        EXPECT_EQ(r.read<uint64_t>(), 3);
+        EXPECT_EQ(r.read<double>(), i);
+        EXPECT_EQ(r.read<double>(), 10.0 * i);
+        EXPECT_EQ(r.read<double>(), 20.0 * i);
+    }
+    EXPECT_TRUE(r.done());
+}
@@ -0,0 +1,84 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/convergence.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+ConvergenceWindow::ConvergenceWindow(size_t _size, double _tolerance)
+    : size(_size), tolerance(_tolerance)
+{
+    assert(size > 0);
+}
+
+void
+ConvergenceWindow::sample(double value)
+{
+    if (samples.size() == size)
+        samples.pop_front();
+    samples.push_back(value);
+}
+
+double
+ConvergenceWindow::spread() const
+{
+    if (samples.empty())
+        return std::numeric_limits<double>::infinity();
+
+    // NaN samples (e.g. a ratio with no events yet) never converge
+    if (std::any_of(samples.begin(), samples.end(),
+                    [](double v) { return std::isnan(v); })) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    auto [min, max] = std::minmax_element(samples.begin(), samples.end());
+    double mean = std::accumulate(samples.begin(), samples.end(), 0.0) /
+        samples.size();
+
+    // A stat stuck at zero (e.g. nothing counted yet) hasn't converged
+    // to anything, so a zero mean never converges.
+    if (mean == 0.0)
+        return std::numeric_limits<double>::infinity();
+    return (*max - *min) / std::fabs(mean);
+}
+
+bool
+ConvergenceWindow::converged() const
+{
+    return samples.size() == size && spread() <= tolerance;
+}
+
+} // namespace statistics
+} // namespace gem5
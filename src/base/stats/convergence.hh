@@ -0,0 +1,83 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_CONVERGENCE_HH__
+#define __BASE_STATS_CONVERGENCE_HH__
+
+#include <cstddef>
+#include <deque>
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Sliding window of the samples of a stat, used to decide whether the
+ * stat has converged.
+ *
+ * The stat is considered converged once the window is full and all its
+ * samples lie within a band of relative width tolerance around their
+ * mean, i.e. (max - min) <= tolerance * |mean|. A window with a zero
+ * mean, e.g. of a stat which hasn't counted anything yet, never
+ * converges. Stats like the IPC of a CPU are cumulative, so sampling
+ * them at regular intervals gives the running estimate of the whole run,
+ * which stabilizes as the run goes on.
+ */
+class ConvergenceWindow
+{
+  private:
+    std::deque<double> samples;
+    size_t size;
+    double tolerance;
+
+  public:
+    /**
+     * @param size Number of samples which have to agree.
+     * @param tolerance Maximum spread of the samples relative to their
+     *        mean.
+     */
+    ConvergenceWindow(size_t size, double tolerance);
+
+    /** Add a sample, dropping the oldest one if the window is full. */
+    void sample(double value);
+
+    /** Drop all the samples, e.g. when the stats are reset. */
+    void clear() { samples.clear(); }
+
+    /** Number of samples in the window. */
+    size_t numSamples() const { return samples.size(); }
+
+    /** Spread of the samples relative to their mean. */
+    double spread() const;
+
+    bool converged() const;
+};
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_CONVERGENCE_HH__
@@ -0,0 +1,94 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "base/stats/convergence.hh"
+
+using namespace gem5;
+
+/** The window only converges once it is full. */
+TEST(StatsConvergenceTest, NeedsFullWindow)
+{
+    statistics::ConvergenceWindow window(3, 0.01);
+    window.sample(1.0);
+    window.sample(1.0);
+    EXPECT_FALSE(window.converged());
+    window.sample(1.0);
+    EXPECT_TRUE(window.converged());
+    EXPECT_EQ(window.spread(), 0.0);
+}
+
+/** Samples spread over more than the tolerance don't converge. */
+TEST(StatsConvergenceTest, Tolerance)
+{
+    statistics::ConvergenceWindow window(3, 0.01);
+    window.sample(1.00);
+    window.sample(1.02);
+    window.sample(1.01);
+    EXPECT_FALSE(window.converged());
+    EXPECT_NEAR(window.spread(), 0.02 / 1.01, 1e-12);
+
+    // The oldest sample leaves the window
+    window.sample(1.015);
+    EXPECT_TRUE(window.converged());
+    EXPECT_EQ(window.numSamples(), 3);
+}
+
+/** NaN and zero-mean samples never converge. */
+TEST(StatsConvergenceTest, Degenerate)
+{
+    statistics::ConvergenceWindow window(2, 0.5);
+    window.sample(NAN);
+    window.sample(1.0);
+    EXPECT_FALSE(window.converged());
+
+    window.sample(-1.0);
+    EXPECT_FALSE(window.converged());
+
+    window.sample(0.0);
+    window.sample(0.0);
+    EXPECT_FALSE(window.converged());
+
+    window.clear();
+    EXPECT_EQ(window.numSamples(), 0);
+    EXPECT_FALSE(window.converged());
+}
+
+/** Equal nonzero samples converge, even with no tolerance. */
+TEST(StatsConvergenceTest, Constant)
+{
+    statistics::ConvergenceWindow window(3, 0.0);
+    window.sample(0.0);
+    window.sample(2.0);
+    window.sample(2.0);
+    EXPECT_FALSE(window.converged());
+
+    window.sample(2.0);
+    EXPECT_TRUE(window.converged());
+    EXPECT_EQ(window.spread(), 0.0);
+}
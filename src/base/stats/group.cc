@@ -37,10 +37,17 @@
 
 #include "base/stats/group.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/stats/info.hh"
+#include "base/stats/output.hh"
 #include "base/trace.hh"
 #include "debug/Stats.hh"
 
@@ -189,5 +196,226 @@ Group::getStats() const
     return stats;
 }
 
+namespace
+{
+
+/** Number of chunks of groups per thread, to balance the load. */
+constexpr size_t ChunksPerThread = 4;
+
+/** A group and the names of its ancestors from the root of a visit. */
+struct GroupPath
+{
+    const Group *group;
+    std::vector<const std::string *> path;
+};
+
+void
+flattenGroups(const Group &group, std::vector<const std::string *> &path,
+              std::vector<GroupPath> &groups)
+{
+    groups.push_back(GroupPath{&group, path});
+    for (const auto &child : group.getStatGroups()) {
+        path.push_back(&child.first);
+        flattenGroups(*child.second, path, groups);
+        path.pop_back();
+    }
+}
+
+/** Stands in for the prerequisite of a FrozenFormula. */
+class FrozenPrereq : public Info
+{
+  private:
+    bool isZero;
+
+  public:
+    FrozenPrereq(bool is_zero) : isZero(is_zero) {}
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return isZero; }
+    void visit(Output &visitor) override {}
+};
+
+/**
+ * A formula evaluated before a concurrent visit. Evaluating a formula
+ * evaluates the stats it refers to, which fill their result caches
+ * (e.g. VectorInfoProxy::rvec), so it can't be done while another thread
+ * visits these stats. The formulas are evaluated serially instead, and
+ * the concurrent visit sees their values through this copy.
+ */
+class FrozenFormula : public FormulaInfo
+{
+  private:
+    VResult vec;
+    VCounter cvec;
+    Result _total;
+    bool _zero;
+    std::string _str;
+    std::unique_ptr<FrozenPrereq> frozenPrereq;
+
+  public:
+    FrozenFormula(const FormulaInfo &info)
+        : vec(info.result()), cvec(info.value()), _total(info.total()),
+          _zero(info.zero()), _str(info.str())
+    {
+        name = info.name;
+        unit = info.unit;
+        desc = info.desc;
+        flags = info.flags;
+        precision = info.precision;
+        id = info.id;
+        subnames = info.subnames;
+        subdescs = info.subdescs;
+        if (info.prereq) {
+            frozenPrereq = std::make_unique<FrozenPrereq>(
+                    info.prereq->zero());
+            prereq = frozenPrereq.get();
+        }
+    }
+
+    size_type size() const override { return vec.size(); }
+    const VCounter &value() const override { return cvec; }
+    const VResult &result() const override { return vec; }
+    Result total() const override { return _total; }
+    std::string str() const override { return _str; }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return _zero; }
+    void visit(Output &visitor) override { visitor.visit(*this); }
+};
+
+using FrozenFormulas =
+    std::unordered_map<const Info *, std::unique_ptr<FrozenFormula>>;
+
+/**
+ * Evaluate all the formulas of the groups ahead of a concurrent visit.
+ *
+ * @return False if the groups can't be visited concurrently, because a
+ * stat other than a formula depends on a formula through its
+ * prerequisite.
+ */
+bool
+freezeFormulas(const std::vector<GroupPath> &groups, FrozenFormulas &frozen)
+{
+    // The copies must not use up stat IDs.
+    const int id_count = Info::id_count;
+    bool concurrent = true;
+    for (const auto &g : groups) {
+        for (const Info *info : g.group->getStats()) {
+            if (auto *formula = dynamic_cast<const FormulaInfo *>(info)) {
+                frozen[info] = std::make_unique<FrozenFormula>(*formula);
+            } else if (dynamic_cast<const FormulaInfo *>(info->prereq)) {
+                concurrent = false;
+            }
+        }
+    }
+    Info::id_count = id_count;
+    return concurrent;
+}
+
+/** Visit consecutive groups, moving the output between their paths. */
+void
+visitGroups(const GroupPath *begin, const GroupPath *end, Output &output,
+            const FrozenFormulas *frozen = nullptr)
+{
+    std::vector<const std::string *> current;
+    for (const GroupPath *g = begin; g != end; ++g) {
+        // The names of the groups are unique objects of the hierarchy,
+        // so comparing their addresses is enough to find the ancestors
+        // shared with the previous group.
+        size_t common = 0;
+        while (common < current.size() && common < g->path.size() &&
+               current[common] == g->path[common]) {
+            common++;
+        }
+        for (size_t i = current.size(); i > common; --i)
+            output.endGroup();
+        for (size_t i = common; i < g->path.size(); ++i)
+            output.beginGroup(g->path[i]->c_str());
+        current = g->path;
+
+        for (Info *info : g->group->getStats()) {
+            if (frozen) {
+                auto it = frozen->find(info);
+                if (it != frozen->end()) {
+                    it->second->visit(output);
+                    continue;
+                }
+            }
+            info->visit(output);
+        }
+    }
+
+    for (size_t i = 0; i < current.size(); ++i)
+        output.endGroup();
+}
+
+} // anonymous namespace
+
+void
+visitGroup(const Group &group, Output &output, unsigned threads)
+{
+    std::vector<GroupPath> groups;
+    std::vector<const std::string *> path;
+    flattenGroups(group, path, groups);
+
+    std::unique_ptr<Output> first;
+    FrozenFormulas frozen;
+    if (threads > 1 && groups.size() > 1 &&
+            freezeFormulas(groups, frozen)) {
+        first = output.partial();
+    }
+
+    if (!first) {
+        visitGroups(groups.data(), groups.data() + groups.size(), output);
+        return;
+    }
+
+    // Split the groups into chunks with similar numbers of stats
+    size_t num_stats = 0;
+    for (const auto &g : groups)
+        num_stats += g.group->getStats().size();
+    size_t max_chunks = std::min(groups.size(), threads * ChunksPerThread);
+    size_t chunk_stats = num_stats / max_chunks + 1;
+
+    std::vector<size_t> bounds = {0};
+    size_t stats_in_chunk = 0;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        stats_in_chunk += groups[i].group->getStats().size();
+        if (stats_in_chunk >= chunk_stats && i + 1 < groups.size()) {
+            bounds.push_back(i + 1);
+            stats_in_chunk = 0;
+        }
+    }
+    bounds.push_back(groups.size());
+
+    size_t num_chunks = bounds.size() - 1;
+    std::vector<std::unique_ptr<Output>> parts;
+    parts.push_back(std::move(first));
+    for (size_t i = 1; i < num_chunks; ++i)
+        parts.push_back(output.partial());
+
+    std::atomic<size_t> next_chunk(0);
+    auto work = [&]() {
+        for (size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+            visitGroups(groups.data() + bounds[c],
+                        groups.data() + bounds[c + 1], *parts[c], &frozen);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min<size_t>(threads, num_chunks); ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto &worker : workers)
+        worker.join();
+
+    for (auto &part : parts)
+        output.merge(*part);
+}
+
 } // namespace statistics
 } // namespace gem5
@@ -79,6 +79,7 @@ namespace statistics
 {
 
 class Info;
+struct Output;
 
 /**
  * Statistics container.
@@ -221,6 +222,31 @@ class Group
     std::vector<Info *> stats;
 };
 
+/**
+ * Visit the stats of a group and of all its sub-groups, in the same
+ * order as the Python stats dump: the stats of a group first, then its
+ * sub-groups sorted by name.
+ *
+ * With more than one thread, and if the output supports partial outputs
+ * (see Output::partial()), the groups are split into chunks with similar
+ * numbers of stats that are evaluated and formatted concurrently, and
+ * the partial outputs are then merged in order so that the result is
+ * identical to a serial visit. The stats must have been prepared.
+ *
+ * Evaluating a stat may fill a result cache of the stat (e.g. the one of
+ * a vector), and formulas evaluate the stats they refer to, which may be
+ * in other chunks. The formulas are therefore evaluated serially before
+ * the concurrent visit. The visit is serial if a stat other than a
+ * formula has a formula as prerequisite.
+ *
+ * @param group Root of the hierarchy to visit.
+ * @param output Output to visit the stats with.
+ * @param threads Maximum number of threads to use.
+ *
+ * @ingroup api_stats
+ */
+void visitGroup(const Group &group, Output &output, unsigned threads = 1);
+
 } // namespace statistics
 } // namespace gem5
 
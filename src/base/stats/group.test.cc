@@ -29,6 +29,11 @@
 #include <gtest/gtest-spi.h>
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "base/stats/group.hh"
 #include "base/stats/info.hh"
 #include "base/stats/output.hh"
@@ -657,3 +662,198 @@ TEST(StatsGroupTest, ResolveStatMergedSubGroup)
     ASSERT_NE(info_found, nullptr);
     ASSERT_EQ(info_found->name, "InfoResolveStatMergedSubGroup");
 }
+
+namespace
+{
+
+class NamedScalarInfo : public statistics::ScalarInfo
+{
+  public:
+    NamedScalarInfo(const std::string &_name) { setName(_name, false); }
+
+    statistics::Counter value() const override { return 0; }
+    statistics::Result result() const override { return 0; }
+    statistics::Result total() const override { return 0; }
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return true; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+};
+
+/** Formula recording the threads that evaluate it. */
+class NamedFormulaInfo : public statistics::FormulaInfo
+{
+  public:
+    mutable statistics::VResult vec;
+    statistics::VCounter cvec;
+    mutable std::vector<std::thread::id> evaluatedBy;
+
+    NamedFormulaInfo(const std::string &_name, statistics::Result value)
+        : vec(1, value)
+    {
+        setName(_name, false);
+    }
+
+    statistics::size_type size() const override { return 1; }
+    const statistics::VCounter &value() const override { return cvec; }
+
+    const statistics::VResult &
+    result() const override
+    {
+        evaluatedBy.push_back(std::this_thread::get_id());
+        return vec;
+    }
+
+    statistics::Result total() const override { return vec[0]; }
+    std::string str() const override { return name; }
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+};
+
+/** Output recording the full names of the stats it visits. */
+class RecordingOutput : public statistics::Output
+{
+  public:
+    std::vector<std::string> path;
+    std::vector<std::string> names;
+
+    void begin() override {}
+    void end() override {}
+    bool valid() const override { return true; }
+
+    void
+    beginGroup(const char *name) override
+    {
+        path.push_back(path.empty() ? name : path.back() + "." + name);
+    }
+
+    void endGroup() override { path.pop_back(); }
+
+    void
+    visit(const statistics::ScalarInfo &info) override
+    {
+        names.push_back(path.empty() ? info.name :
+                        path.back() + "." + info.name);
+    }
+
+    void visit(const statistics::VectorInfo &info) override {}
+    void visit(const statistics::DistInfo &info) override {}
+    void visit(const statistics::VectorDistInfo &info) override {}
+    void visit(const statistics::Vector2dInfo &info) override {}
+    void
+    visit(const statistics::FormulaInfo &info) override
+    {
+        names.push_back((path.empty() ? info.name :
+                         path.back() + "." + info.name) + "=" +
+                        std::to_string(info.result()[0]));
+    }
+
+    void visit(const statistics::SparseHistInfo &info) override {}
+
+    std::unique_ptr<statistics::Output>
+    partial() const override
+    {
+        auto part = std::make_unique<RecordingOutput>();
+        part->path = path;
+        return part;
+    }
+
+    void
+    merge(statistics::Output &part) override
+    {
+        auto &recording = dynamic_cast<RecordingOutput &>(part);
+        names.insert(names.end(), recording.names.begin(),
+                     recording.names.end());
+    }
+};
+
+} // anonymous namespace
+
+/** Test that visiting a hierarchy in parallel matches a serial visit. */
+TEST(StatsGroupTest, VisitGroup)
+{
+    statistics::Group root(nullptr);
+    NamedScalarInfo root_info("rootStat");
+    root.addStat(&root_info);
+
+    std::vector<std::unique_ptr<statistics::Group>> groups;
+    std::vector<std::unique_ptr<NamedScalarInfo>> infos;
+    for (int i = 0; i < 8; i++) {
+        groups.push_back(std::make_unique<statistics::Group>(nullptr));
+        statistics::Group *cpu = groups.back().get();
+        root.addStatGroup(("cpu" + std::to_string(i)).c_str(), cpu);
+        for (int j = 0; j < i; j++) {
+            infos.push_back(std::make_unique<NamedScalarInfo>(
+                        "stat" + std::to_string(j)));
+            cpu->addStat(infos.back().get());
+        }
+
+        groups.push_back(std::make_unique<statistics::Group>(nullptr));
+        cpu->addStatGroup("cache", groups.back().get());
+        infos.push_back(std::make_unique<NamedScalarInfo>("misses"));
+        groups.back()->addStat(infos.back().get());
+    }
+
+    RecordingOutput serial;
+    serial.beginGroup("system");
+    statistics::visitGroup(root, serial);
+    serial.endGroup();
+
+    ASSERT_EQ(serial.names.size(), 1 + 28 + 8);
+    ASSERT_EQ(serial.names[0], "system.rootStat");
+    ASSERT_EQ(serial.names[1], "system.cpu0.cache.misses");
+    ASSERT_EQ(serial.names[2], "system.cpu1.stat0");
+    ASSERT_EQ(serial.names[3], "system.cpu1.cache.misses");
+
+    for (unsigned threads : {2, 3, 16}) {
+        RecordingOutput parallel;
+        parallel.beginGroup("system");
+        statistics::visitGroup(root, parallel, threads);
+        parallel.endGroup();
+        ASSERT_EQ(serial.names, parallel.names);
+    }
+}
+
+/** Test that formulas are only evaluated by the calling thread. */
+TEST(StatsGroupTest, VisitGroupFormulas)
+{
+    statistics::Group root(nullptr);
+    std::vector<std::unique_ptr<statistics::Group>> groups;
+    std::vector<std::unique_ptr<NamedScalarInfo>> infos;
+    std::vector<std::unique_ptr<NamedFormulaInfo>> formulas;
+    for (int i = 0; i < 8; i++) {
+        groups.push_back(std::make_unique<statistics::Group>(nullptr));
+        statistics::Group *cpu = groups.back().get();
+        root.addStatGroup(("cpu" + std::to_string(i)).c_str(), cpu);
+        for (int j = 0; j < 4; j++) {
+            infos.push_back(std::make_unique<NamedScalarInfo>(
+                        "stat" + std::to_string(j)));
+            cpu->addStat(infos.back().get());
+        }
+        formulas.push_back(std::make_unique<NamedFormulaInfo>("ipc", i));
+        cpu->addStat(formulas.back().get());
+    }
+
+    RecordingOutput serial;
+    statistics::visitGroup(root, serial);
+    ASSERT_EQ(serial.names.size(), 8 * 5);
+    ASSERT_EQ(serial.names[4], "cpu0.ipc=0.000000");
+    ASSERT_EQ(serial.names[39], "cpu7.ipc=7.000000");
+
+    const int id_count = statistics::Info::id_count;
+    for (unsigned threads : {2, 16}) {
+        RecordingOutput parallel;
+        statistics::visitGroup(root, parallel, threads);
+        ASSERT_EQ(serial.names, parallel.names);
+    }
+    ASSERT_EQ(statistics::Info::id_count, id_count);
+
+    for (const auto &formula : formulas) {
+        for (const auto &id : formula->evaluatedBy)
+            ASSERT_EQ(id, std::this_thread::get_id());
+    }
+}
@@ -42,6 +42,7 @@
 #define __BASE_STATS_OUTPUT_HH__
 
 #include <list>
+#include <memory>
 #include <string>
 
 #include "base/compiler.hh"
@@ -80,6 +81,19 @@ struct Output
     virtual void visit(const Vector2dInfo &info) = 0;
     virtual void visit(const FormulaInfo &info) = 0;
     virtual void visit(const SparseHistInfo &info) = 0; // Sparse histogram
+
+    /**
+     * Create an output that formats stats like this one, starting from
+     * the current group, into a private buffer. This lets parts of the
+     * hierarchy be visited concurrently (see visitGroup()).
+     *
+     * @return The new output, or nullptr if this output can only be
+     * visited serially.
+     */
+    virtual std::unique_ptr<Output> partial() const { return nullptr; }
+
+    /** Append the stats buffered by an output created by partial(). */
+    virtual void merge(Output &part) {}
 };
 
 } // namespace statistics
@@ -140,6 +140,26 @@ Text::end()
     stream->flush();
 }
 
+std::unique_ptr<Output>
+Text::partial() const
+{
+    auto part = std::make_unique<Text>();
+    part->mystream = true;
+    part->stream = new std::ostringstream();
+    part->path = path;
+    part->enableUnits = enableUnits;
+    part->descriptions = descriptions;
+    part->spaces = spaces;
+    return part;
+}
+
+void
+Text::merge(Output &part)
+{
+    auto &text = dynamic_cast<Text &>(part);
+    *stream << static_cast<std::ostringstream *>(text.stream)->str();
+}
+
 std::string
 Text::statName(const std::string &name) const
 {
@@ -239,6 +239,21 @@ class BaseCPU : public ClockedObject
 
     virtual void wakeup(ThreadID tid) = 0;
 
+    /**
+     * Notify the CPU of a functional write made on behalf of one of its
+     * threads (e.g. by an emulated system call). Those writes leave
+     * through the data port, so the CPU does not snoop them.
+     */
+    virtual void threadFunctionalWrite(PacketPtr pkt) {}
+
+    /**
+     * Notify the CPU of a write to memory it may not have snooped, e.g.
+     * a DMA write or one made through a memory backdoor in the
+     * 'atomic_noncaching' mode. Only the CPUs registered with
+     * System::registerMemWriteListener() are told.
+     */
+    virtual void unsnoopedWrite(PacketPtr pkt) {}
+
     void postInterrupt(ThreadID tid, int int_num, int index);
 
     void
@@ -1417,6 +1417,14 @@ CPU::wakeCPU()
 void
 CPU::wakeup(ThreadID tid)
 {
+    if (thread[tid]->status() == gem5::ThreadContext::Active) {
+        // Commit polls for interrupts, make sure it gets to see this one
+        // if the pipeline went idle while waiting for memory.
+        if (_status == Running && drainState() == DrainState::Running)
+            wakeCPU();
+        return;
+    }
+
     if (thread[tid]->status() != gem5::ThreadContext::Suspended)
         return;
 
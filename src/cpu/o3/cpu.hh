@@ -55,6 +55,7 @@
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/commit.hh"
 #include "cpu/o3/decode.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/fetch.hh"
 #include "cpu/o3/free_list.hh"
@@ -373,6 +374,13 @@ class CPU : public BaseCPU
     void dumpInsts();
 
   public:
+    /**
+     * Recycled storage for the DynInsts of this CPU. It is declared ahead
+     * of every structure that can hold instructions so that it is
+     * destroyed after all of them.
+     */
+    DynInstPool dynInstPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
@@ -107,17 +107,17 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &_staticInst,
 {}
 
 /*
- * This custom "new" operator uses the default "new" operator to allocate space
+ * This custom "new" operator uses the CPU's DynInstPool to allocate space
  * for a DynInst, but also pads out the number of bytes to make room for some
  * extra structures the DynInst needs. We save time and improve performance by
  * only going to the heap once to get space for all these structures.
  *
  * When a DynInst is allocated with new, the compiler will call this "new"
  * operator with "count" set to the number of bytes it needs to store the
- * DynInst. We ultimately call into the default new operator to get those
- * bytes, but before we do, we pad out "count" so that there will be extra
- * space for some structures the DynInst needs. We take into account both the
- * absolute size of these structures, and also what alignment they need.
+ * DynInst. We ultimately call into the pool to get those bytes, but before
+ * we do, we pad out "count" so that there will be extra space for some
+ * structures the DynInst needs. We take into account both the absolute size
+ * of these structures, and also what alignment they need.
  *
  * Once we've gotten a buffer large enough to hold the DynInst itself and these
  * extra structures, we construct the extra bits using placement new. This
@@ -134,7 +134,7 @@ DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &_staticInst,
  * and are then consumed in the DynInst constructor.
  */
 void *
-DynInst::operator new(size_t count, Arrays &arrays)
+DynInst::operator new(size_t count, Arrays &arrays, DynInstPool &pool)
 {
     // Convenience variables for brevity.
     const auto num_dests = arrays.numDests;
@@ -167,8 +167,9 @@ DynInst::operator new(size_t count, Arrays &arrays)
     // Figure out how much space we need in total.
     size_t total_size = ready_src_idx + ready_src_idx_size;
 
-    // Actually allocate it.
-    uint8_t *buf = (uint8_t *)::operator new(total_size);
+    // Actually allocate it. Blocks are recycled by the pool, so this
+    // only reaches the heap while the pipeline is filling up.
+    uint8_t *buf = (uint8_t *)pool.allocate(total_size);
 
     // Fill in "arrays" with pointers to all the arrays.
     arrays.flatDestIdx = (RegId *)(buf + flat_dest_idx);
@@ -187,6 +188,26 @@ DynInst::operator new(size_t count, Arrays &arrays)
     return buf;
 }
 
+/*
+ * Only called if a constructor throws after the placement new above.
+ */
+void
+DynInst::operator delete(void *ptr, Arrays &arrays, DynInstPool &pool)
+{
+    DynInstPool::deallocate(ptr);
+}
+
+/*
+ * The memory of a DynInst always comes from a DynInstPool, which records
+ * where it has to be returned, so this is what the last reference going
+ * away ends up calling.
+ */
+void
+DynInst::operator delete(void *ptr)
+{
+    DynInstPool::deallocate(ptr);
+}
+
 DynInst::~DynInst()
 {
     /*
@@ -57,6 +57,7 @@
 #include "cpu/inst_res.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/lsq_unit.hh"
 #include "cpu/op_class.hh"
@@ -95,7 +96,11 @@ class DynInst : public ExecContext, public RefCounted
         uint8_t *readySrcIdx;
     };
 
-    static void *operator new(size_t count, Arrays &arrays);
+    static void *operator new(size_t count, Arrays &arrays,
+                              DynInstPool &pool);
+    static void operator delete(void *ptr, Arrays &arrays,
+                                DynInstPool &pool);
+    static void operator delete(void *ptr);
 
     /** BaseDynInst constructor given a binary instruction. */
     DynInst(const Arrays &arrays, const StaticInstPtr &staticInst,
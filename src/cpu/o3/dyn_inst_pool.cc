@@ -0,0 +1,112 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/dyn_inst_pool.hh"
+
+#include <new>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+DynInstPool::~DynInstPool()
+{
+    // Instructions still alive at this point would hand their memory back
+    // to a dead pool, so only release the slabs if none are left.
+    if (numOutstanding)
+        return;
+
+    for (void *slab : slabs)
+        ::operator delete(slab, std::align_val_t(Granularity));
+}
+
+void
+DynInstPool::refill(uint32_t size_class)
+{
+    const size_t block_size = size_class * Granularity;
+    const size_t slab_size = block_size * BlocksPerSlab;
+    uint8_t *slab = (uint8_t *)::operator new(
+            slab_size, std::align_val_t(Granularity));
+    slabs.push_back(slab);
+    numReservedBytes += slab_size;
+
+    // Thread the blocks so that they are handed out in address order.
+    FreeBlock *head = freeLists[size_class];
+    for (size_t i = BlocksPerSlab; i-- > 0;) {
+        FreeBlock *block = (FreeBlock *)(slab + i * block_size);
+        block->next = head;
+        head = block;
+    }
+    freeLists[size_class] = head;
+}
+
+void *
+DynInstPool::allocate(size_t size)
+{
+    const uint32_t size_class =
+        divCeil(HeaderSize + size, Granularity);
+
+    if (size_class >= freeLists.size())
+        freeLists.resize(size_class + 1, nullptr);
+
+    if (!freeLists[size_class])
+        refill(size_class);
+
+    FreeBlock *block = freeLists[size_class];
+    freeLists[size_class] = block->next;
+
+    Header *header = (Header *)block;
+    header->pool = this;
+    header->sizeClass = size_class;
+    numOutstanding++;
+
+    return (uint8_t *)block + HeaderSize;
+}
+
+void
+DynInstPool::deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Header *header = (Header *)((uint8_t *)ptr - HeaderSize);
+    DynInstPool *pool = header->pool;
+    const uint32_t size_class = header->sizeClass;
+    assert(pool && size_class < pool->freeLists.size());
+    assert(pool->numOutstanding);
+
+    FreeBlock *block = (FreeBlock *)header;
+    block->next = pool->freeLists[size_class];
+    pool->freeLists[size_class] = block;
+    pool->numOutstanding--;
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,115 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_DYN_INST_POOL_HH__
+#define __CPU_O3_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Per-CPU slab allocator for DynInsts.
+ *
+ * A DynInst and its trailing operand arrays are allocated as a single
+ * block whose size depends on the number of operands of the instruction.
+ * Blocks are rounded up to a multiple of a cache line and recycled
+ * through one free list per size, and new blocks are carved out of
+ * cache line aligned slabs, so that once the pipeline is warmed up
+ * fetching and retiring instructions never goes to the heap.
+ *
+ * Each block starts with a small header recording the pool and the size
+ * class it belongs to, which lets the DynInst operator delete return the
+ * memory without needing any information from the (already destroyed)
+ * instruction. The pool must outlive all the instructions allocated from
+ * it.
+ */
+class DynInstPool
+{
+  public:
+    DynInstPool() = default;
+    ~DynInstPool();
+
+    DynInstPool(const DynInstPool &) = delete;
+    DynInstPool &operator=(const DynInstPool &) = delete;
+
+    /** Allocate size bytes aligned to alignof(std::max_align_t). */
+    void *allocate(size_t size);
+
+    /** Return a block obtained from allocate() to its pool. */
+    static void deallocate(void *ptr);
+
+    /** Number of blocks currently handed out. */
+    size_t outstanding() const { return numOutstanding; }
+
+    /** Total number of bytes reserved in slabs. */
+    size_t reservedBytes() const { return numReservedBytes; }
+
+  private:
+    struct Header
+    {
+        DynInstPool *pool;
+        uint32_t sizeClass;
+    };
+
+    /** Link used while a block sits on a free list. */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    static constexpr size_t HeaderSize =
+        (sizeof(Header) + alignof(std::max_align_t) - 1) &
+        ~(alignof(std::max_align_t) - 1);
+
+    /** Block sizes are multiples of this many bytes. */
+    static constexpr size_t Granularity = 64;
+
+    /** Number of blocks carved out of each new slab. */
+    static constexpr size_t BlocksPerSlab = 32;
+
+    /** Allocate a new slab of blocks of the given size class. */
+    void refill(uint32_t size_class);
+
+    /** Free lists, indexed by size class. */
+    std::vector<FreeBlock *> freeLists;
+
+    /** All the slabs allocated by this pool. */
+    std::vector<void *> slabs;
+
+    size_t numOutstanding = 0;
+    size_t numReservedBytes = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_DYN_INST_POOL_HH__
@@ -1052,7 +1052,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
     arrays.numDests = staticInst->numDestRegs();
 
     // Create a new DynInst from the instruction fetched.
-    DynInstPtr instruction = new (arrays) DynInst(
+    DynInstPtr instruction = new (arrays, cpu->dynInstPool) DynInst(
             arrays, staticInst, curMacroop, this_pc, next_pc, seq, cpu);
     instruction->setTid(tid);
 
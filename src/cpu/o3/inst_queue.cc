@@ -112,7 +112,23 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
 
     //Create an entry for each physical register within the
     //dependency graph.
-    dependGraph.resize(numPhysRegs);
+    if (params.iqScheduler == IQScheduler::Matrix) {
+        wakeupMatrix = std::make_unique<WakeupMatrix<DynInstPtr>>();
+        wakeupMatrix->resize(numPhysRegs, numEntries);
+        readyBitmap = std::make_unique<ReadyBitmap<DynInstPtr>>();
+        readyBitmap->resize(numEntries);
+    } else {
+        dependGraph.resize(numPhysRegs);
+    }
+
+    // Instructions stay in the instruction list until IEW hears that
+    // they committed, so a thread can have up to a full ROB of them,
+    // plus the ones that committed since.
+    size_t list_size = params.numROBEntries +
+        params.commitWidth * params.commitToIEWDelay;
+    instList.reserve(MaxThreads);
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        instList.emplace_back(tid < numThreads ? list_size : 0);
 
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
@@ -395,7 +411,7 @@ InstructionQueue::resetState()
     //Initialize thread IQ counts
     for (ThreadID tid = 0; tid < MaxThreads; tid++) {
         count[tid] = 0;
-        instList[tid].clear();
+        instList[tid].flush();
     }
 
     // Initialize the number of free IQ entries.
@@ -420,6 +436,10 @@ InstructionQueue::resetState()
         queueOnList[i] = false;
         readyIt[i] = listOrder.end();
     }
+    if (wakeupMatrix) {
+        wakeupMatrix->reset();
+        readyBitmap->reset();
+    }
     nonSpecInsts.clear();
     listOrder.clear();
     deferredMemInsts.clear();
@@ -451,7 +471,8 @@ InstructionQueue::setTimeBuffer(TimeBuffer<TimeStruct> *tb_ptr)
 bool
 InstructionQueue::isDrained() const
 {
-    bool drained = dependGraph.empty() &&
+    bool drained = (wakeupMatrix ? wakeupMatrix->empty() :
+                                   dependGraph.empty()) &&
                    instsToExecute.empty() &&
                    wbOutstanding == 0;
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -463,7 +484,7 @@ InstructionQueue::isDrained() const
 void
 InstructionQueue::drainSanityCheck() const
 {
-    assert(dependGraph.empty());
+    assert(wakeupMatrix ? wakeupMatrix->empty() : dependGraph.empty());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -545,6 +566,9 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
+    if (readyBitmap)
+        return !readyBitmap->empty();
+
     if (!listOrder.empty()) {
         return true;
     }
@@ -576,6 +600,9 @@ InstructionQueue::insert(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
+    panic_if(instList[new_inst->threadNumber].full(),
+             "[tid:%i] IQ instruction list overflow at [sn:%llu].",
+             new_inst->threadNumber, new_inst->seqNum);
     instList[new_inst->threadNumber].push_back(new_inst);
 
     --freeEntries;
@@ -626,6 +653,9 @@ InstructionQueue::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
+    panic_if(instList[new_inst->threadNumber].full(),
+             "[tid:%i] IQ instruction list overflow at [sn:%llu].",
+             new_inst->threadNumber, new_inst->seqNum);
     instList[new_inst->threadNumber].push_back(new_inst);
 
     --freeEntries;
@@ -744,6 +774,106 @@ InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
     instsToExecute.push_back(inst);
 }
 
+InstructionQueue::IssueResult
+InstructionQueue::issueInst(const DynInstPtr &issuing_inst, OpClass op_class,
+        IssueStruct *i2e_info)
+{
+    if (issuing_inst->isFloating()) {
+        iqIOStats.fpInstQueueReads++;
+    } else if (issuing_inst->isVector()) {
+        iqIOStats.vecInstQueueReads++;
+    } else {
+        iqIOStats.intInstQueueReads++;
+    }
+
+    if (issuing_inst->isSquashed()) {
+        ++iqStats.squashedInstsIssued;
+        return IssueResult::Squashed;
+    }
+
+    int idx = FUPool::NoCapableFU;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
+
+    if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        if (issuing_inst->isFloating()) {
+            iqIOStats.fpAluAccesses++;
+        } else if (issuing_inst->isVector()) {
+            iqIOStats.vecAluAccesses++;
+        } else {
+            iqIOStats.intAluAccesses++;
+        }
+        if (idx > FUPool::NoFreeFU) {
+            op_latency = fuPool->getOpLatency(op_class);
+        }
+    }
+
+    // Only an instruction that doesn't require a FU, or that got a
+    // valid FU, can be scheduled for execution.
+    if (idx == FUPool::NoFreeFU) {
+        iqStats.statFuBusy[op_class]++;
+        iqStats.fuBusy[tid]++;
+        return IssueResult::FUBusy;
+    }
+
+    if (op_latency == Cycles(1)) {
+        i2e_info->size++;
+        instsToExecute.push_back(issuing_inst);
+
+        // Add the FU onto the list of FU's to be freed next
+        // cycle if we used one.
+        if (idx >= 0)
+            fuPool->freeUnitNextCycle(idx);
+    } else {
+        bool pipelined = fuPool->isPipelined(op_class);
+        // Generate completion event for the FU
+        ++wbOutstanding;
+        FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                   idx, this);
+
+        cpu->schedule(execution,
+                      cpu->clockEdge(Cycles(op_latency - 1)));
+
+        if (!pipelined) {
+            // If FU isn't pipelined, then it must be freed
+            // upon the execution completing.
+            execution->setFreeFU();
+        } else {
+            // Add the FU onto the list of FU's to be freed next cycle.
+            fuPool->freeUnitNextCycle(idx);
+        }
+    }
+
+    DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+            "[sn:%llu]\n",
+            tid, issuing_inst->pcState(),
+            issuing_inst->seqNum);
+
+    issuing_inst->setIssued();
+
+#if TRACING_ON
+    issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+#endif
+
+    if (issuing_inst->firstIssue == -1)
+        issuing_inst->firstIssue = curTick();
+
+    if (!issuing_inst->isMemRef()) {
+        // Memory instructions can not be freed from the IQ until they
+        // complete.
+        ++freeEntries;
+        count[tid]--;
+        issuing_inst->clearInIQ();
+    } else {
+        memDepUnit[tid].issue(issuing_inst);
+    }
+
+    iqStats.statIssuedInstType[tid][op_class]++;
+
+    return IssueResult::Issued;
+}
+
 // @todo: Figure out a better way to remove the squashed items from the
 // lists.  Checking the top item of each list to see if it's squashed
 // wastes time and forces jumps.
@@ -774,97 +904,48 @@ InstructionQueue::scheduleReadyInsts()
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
-
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
 
-        assert(!readyInsts[op_class].empty());
-
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
-
-        if (issuing_inst->isFloating()) {
-            iqIOStats.fpInstQueueReads++;
-        } else if (issuing_inst->isVector()) {
-            iqIOStats.vecInstQueueReads++;
-        } else {
-            iqIOStats.intInstQueueReads++;
-        }
-
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
-        if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+    if (readyBitmap) {
+        // Same selection as below: always try the oldest ready
+        // instruction among the op classes that still have a free FU.
+        ReadyBitmap<DynInstPtr>::ClassMask fu_busy = {};
+        while (total_issued < totalWidth) {
+            int slot = readyBitmap->oldest(fu_busy);
+            if (slot < 0)
+                break;
+
+            DynInstPtr issuing_inst = readyBitmap->inst(slot);
+            OpClass op_class = readyBitmap->opClass(slot);
+
+            IssueResult result = issueInst(issuing_inst, op_class, i2e_info);
+            if (result == IssueResult::FUBusy) {
+                ReadyBitmap<DynInstPtr>::block(fu_busy, op_class);
+                continue;
             }
 
-            listOrder.erase(order_it++);
+            readyBitmap->pop(slot);
+            if (result == IssueResult::Issued)
+                ++total_issued;
+        }
+    } else {
+        ListOrderIt order_it = listOrder.begin();
+        ListOrderIt order_end_it = listOrder.end();
 
-            ++iqStats.squashedInstsIssued;
+        while (total_issued < totalWidth && order_it != order_end_it) {
+            OpClass op_class = (*order_it).queueType;
 
-            continue;
-        }
+            assert(!readyInsts[op_class].empty());
 
-        int idx = FUPool::NoCapableFU;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
+            DynInstPtr issuing_inst = readyInsts[op_class].top();
 
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            if (issuing_inst->isFloating()) {
-                iqIOStats.fpAluAccesses++;
-            } else if (issuing_inst->isVector()) {
-                iqIOStats.vecAluAccesses++;
-            } else {
-                iqIOStats.intAluAccesses++;
-            }
-            if (idx > FUPool::NoFreeFU) {
-                op_latency = fuPool->getOpLatency(op_class);
-            }
-        }
+            assert(issuing_inst->seqNum == (*order_it).oldestInst);
 
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx != FUPool::NoFreeFU) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                bool pipelined = fuPool->isPipelined(op_class);
-                // Generate completion event for the FU
-                ++wbOutstanding;
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                if (!pipelined) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
+            IssueResult result = issueInst(issuing_inst, op_class, i2e_info);
+            if (result == IssueResult::FUBusy) {
+                ++order_it;
+                continue;
             }
 
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%llu]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
-
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
@@ -874,32 +955,10 @@ InstructionQueue::scheduleReadyInsts()
                 queueOnList[op_class] = false;
             }
 
-            issuing_inst->setIssued();
-            ++total_issued;
-
-#if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
-#endif
-
-            if (issuing_inst->firstIssue == -1)
-                issuing_inst->firstIssue = curTick();
-
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
-
             listOrder.erase(order_it++);
-            iqStats.statIssuedInstType[tid][op_class]++;
-        } else {
-            iqStats.statFuBusy[op_class]++;
-            iqStats.fuBusy[tid]++;
-            ++order_it;
+
+            if (result == IssueResult::Issued)
+                ++total_issued;
         }
     }
 
@@ -907,10 +966,10 @@ InstructionQueue::scheduleReadyInsts()
     iqStats.instsIssued+= total_issued;
 
     // If we issued any instructions, tell the CPU we had activity.
-    // @todo If the way deferred memory instructions are handeled due to
-    // translation changes then the deferredMemInsts condition should be
-    // removed from the code below.
-    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
+    // Deferred memory instructions don't count: the LSQ wakes the CPU up
+    // when their translation completes, so there is no need to keep
+    // ticking while the page table walk is in progress.
+    if (total_issued || !retryMemInsts.empty()) {
         cpu->activityThisCycle();
     } else {
         DPRINTF(IQ, "Not able to schedule any instructions.\n");
@@ -950,12 +1009,11 @@ InstructionQueue::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i] Committing instructions older than [sn:%llu]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
+    CircularQueue<DynInstPtr> &insts = instList[tid];
 
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
-        instList[tid].pop_front();
+    while (!insts.empty() && insts.front()->seqNum <= inst) {
+        insts.front() = nullptr;
+        insts.pop_front();
     }
 
     assert(freeEntries == (numEntries - countInsts()));
@@ -1032,29 +1090,33 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
 
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
+        if (wakeupMatrix) {
+            dependents += wakeMatrixDependents(dest_reg->flatIndex());
+        } else {
+            DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
 
-        while (dep_inst) {
-            DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
-                    "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+            while (dep_inst) {
+                DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
+                        "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
 
-            // Might want to give more information to the instruction
-            // so that it knows which of its source registers is
-            // ready.  However that would mean that the dependency
-            // graph entries would need to hold the src_reg_idx.
-            dep_inst->markSrcRegReady();
+                // Might want to give more information to the instruction
+                // so that it knows which of its source registers is
+                // ready.  However that would mean that the dependency
+                // graph entries would need to hold the src_reg_idx.
+                dep_inst->markSrcRegReady();
 
-            addIfReady(dep_inst);
+                addIfReady(dep_inst);
 
-            dep_inst = dependGraph.pop(dest_reg->flatIndex());
+                dep_inst = dependGraph.pop(dest_reg->flatIndex());
 
-            ++dependents;
-        }
+                ++dependents;
+            }
 
-        // Reset the head node now that all of its dependents have
-        // been woken up.
-        assert(dependGraph.empty(dest_reg->flatIndex()));
-        dependGraph.clearInst(dest_reg->flatIndex());
+            // Reset the head node now that all of its dependents have
+            // been woken up.
+            assert(dependGraph.empty(dest_reg->flatIndex()));
+            dependGraph.clearInst(dest_reg->flatIndex());
+        }
 
         // Mark the scoreboard as having that register ready.
         regScoreboard[dest_reg->flatIndex()] = true;
@@ -1062,22 +1124,46 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
     return dependents;
 }
 
+int
+InstructionQueue::wakeMatrixDependents(RegIndex reg)
+{
+    int dependents = 0;
+
+    DynInstPtr dep_inst = wakeupMatrix->pop(reg);
+
+    while (dep_inst) {
+        DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
+                "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+
+        // The matrix only records that the instruction waits on the
+        // register, so mark every operand that reads it as ready.
+        for (int src_reg_idx = 0;
+             src_reg_idx < dep_inst->numSrcRegs();
+             src_reg_idx++)
+        {
+            PhysRegIdPtr src_reg = dep_inst->renamedSrcIdx(src_reg_idx);
+            if (!dep_inst->readySrcIdx(src_reg_idx) &&
+                !src_reg->isFixedMapping() &&
+                src_reg->flatIndex() == reg) {
+                dep_inst->markSrcRegReady();
+                ++dependents;
+            }
+        }
+
+        addIfReady(dep_inst);
+
+        dep_inst = wakeupMatrix->pop(reg);
+    }
+
+    return dependents;
+}
+
 void
 InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    addToReadyList(ready_inst, op_class);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1183,19 +1269,17 @@ InstructionQueue::squash(ThreadID tid)
 void
 InstructionQueue::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
+    CircularQueue<DynInstPtr> &insts = instList[tid];
 
     DPRINTF(IQ, "[tid:%i] Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
+    // given, starting at the tail.
+    while (!insts.empty() && insts.back()->seqNum > squashedSeqNum[tid]) {
 
-        DynInstPtr squashed_inst = (*squash_it);
+        DynInstPtr squashed_inst = std::move(insts.back());
+        insts.pop_back();
         if (squashed_inst->isFloating()) {
             iqIOStats.fpInstQueueWrites++;
         } else if (squashed_inst->isVector()) {
@@ -1208,7 +1292,6 @@ InstructionQueue::doSquash(ThreadID tid)
         // hasn't already been squashed in the IQ.
         if (squashed_inst->threadNumber != tid ||
             squashed_inst->isSquashedInIQ()) {
-            --squash_it;
             continue;
         }
 
@@ -1250,8 +1333,13 @@ InstructionQueue::doSquash(ThreadID tid)
 
                     if (!squashed_inst->readySrcIdx(src_reg_idx) &&
                         !src_reg->isFixedMapping()) {
-                        dependGraph.remove(src_reg->flatIndex(),
-                                           squashed_inst);
+                        if (wakeupMatrix) {
+                            wakeupMatrix->remove(src_reg->flatIndex(),
+                                                 squashed_inst);
+                        } else {
+                            dependGraph.remove(src_reg->flatIndex(),
+                                               squashed_inst);
+                        }
                     }
 
                     ++iqStats.squashedOperandsExamined;
@@ -1314,10 +1402,13 @@ InstructionQueue::doSquash(ThreadID tid)
             if (dest_reg->isFixedMapping()){
                 continue;
             }
+            if (wakeupMatrix) {
+                assert(wakeupMatrix->empty(dest_reg->flatIndex()));
+                continue;
+            }
             assert(dependGraph.empty(dest_reg->flatIndex()));
             dependGraph.clearInst(dest_reg->flatIndex());
         }
-        instList[tid].erase(squash_it--);
         ++iqStats.squashedInstsExamined;
     }
 }
@@ -1336,6 +1427,7 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
     // them to the dependency list if they are not ready.
     int8_t total_src_regs = new_inst->numSrcRegs();
     bool return_val = false;
+    int matrix_slot = -1;
 
     for (int src_reg_idx = 0;
          src_reg_idx < total_src_regs;
@@ -1357,7 +1449,13 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                if (wakeupMatrix) {
+                    if (matrix_slot < 0)
+                        matrix_slot = wakeupMatrix->allocate(new_inst);
+                    wakeupMatrix->insert(src_reg->flatIndex(), matrix_slot);
+                } else {
+                    dependGraph.insert(src_reg->flatIndex(), new_inst);
+                }
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1397,14 +1495,23 @@ InstructionQueue::addToProducers(const DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
-            dependGraph.dump();
-            panic("Dependency graph %i (%s) (flat: %i) not empty!",
-                  dest_reg->index(), dest_reg->className(),
-                  dest_reg->flatIndex());
-        }
+        if (wakeupMatrix) {
+            if (!wakeupMatrix->empty(dest_reg->flatIndex())) {
+                wakeupMatrix->dump();
+                panic("Wakeup matrix row %i (%s) (flat: %i) not empty!",
+                      dest_reg->index(), dest_reg->className(),
+                      dest_reg->flatIndex());
+            }
+        } else {
+            if (!dependGraph.empty(dest_reg->flatIndex())) {
+                dependGraph.dump();
+                panic("Dependency graph %i (%s) (flat: %i) not empty!",
+                      dest_reg->index(), dest_reg->className(),
+                      dest_reg->flatIndex());
+            }
 
-        dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+            dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+        }
 
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg->flatIndex()] = false;
@@ -1436,17 +1543,28 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
+        addToReadyList(inst, op_class);
+    }
+}
 
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+void
+InstructionQueue::addToReadyList(const DynInstPtr &inst, OpClass op_class)
+{
+    if (readyBitmap) {
+        readyBitmap->push(inst, op_class);
+        return;
+    }
+
+    readyInsts[op_class].push(inst);
+
+    // Will need to reorder the list if either a queue is not on the list,
+    // or it has an older instruction than last time.
+    if (!queueOnList[op_class]) {
+        addToOrderList(op_class);
+    } else if (readyInsts[op_class].top()->seqNum  <
+               (*readyIt[op_class]).oldestInst) {
+        listOrder.erase(readyIt[op_class]);
+        addToOrderList(op_class);
     }
 }
 
@@ -1460,7 +1578,8 @@ void
 InstructionQueue::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i, readyBitmap ?
+                readyBitmap->size((OpClass)i) : readyInsts[i].size());
 
         cprintf("\n");
     }
@@ -1504,7 +1623,7 @@ InstructionQueue::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        auto inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
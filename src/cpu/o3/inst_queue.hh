@@ -44,9 +44,11 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
@@ -56,8 +58,10 @@
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
 #include "cpu/o3/store_set.hh"
+#include "cpu/o3/wakeup_matrix.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
+#include "enums/IQScheduler.hh"
 #include "enums/SMTQueuePolicy.hh"
 #include "sim/eventq.hh"
 
@@ -102,7 +106,7 @@ class InstructionQueue
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
     /** FU completion event class. */
-    class FUCompletion : public Event
+    class FUCompletion : public Event, public EventPoolAllocated
     {
       private:
         /** Executing instruction. */
@@ -317,8 +321,13 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /**
+     * List of all the instructions in the IQ (some of which may be
+     * issued), one per thread. Instructions are inserted in program
+     * order, committed from the head and squashed from the tail, so
+     * each list is a ring buffer.
+     */
+    std::vector<CircularQueue<DynInstPtr>> instList;
 
     /** List of instructions that are ready to be executed. */
     std::list<DynInstPtr> instsToExecute;
@@ -404,6 +413,39 @@ class InstructionQueue
 
     DependencyGraph<DynInstPtr> dependGraph;
 
+    /**
+     * Wakeup matrix and ready bitmaps, used instead of the dependency
+     * graph, ready queues and age order list when the Matrix scheduler
+     * is selected. Both select instructions in the same order.
+     */
+    std::unique_ptr<WakeupMatrix<DynInstPtr>> wakeupMatrix;
+    std::unique_ptr<ReadyBitmap<DynInstPtr>> readyBitmap;
+
+    /** Outcome of an attempt to issue a ready instruction. */
+    enum class IssueResult
+    {
+        Squashed,
+        Issued,
+        FUBusy
+    };
+
+    /**
+     * Tries to issue the oldest ready instruction of an op class to a
+     * functional unit. The caller removes the instruction from the
+     * ready structures unless the result is FUBusy.
+     */
+    IssueResult issueInst(const DynInstPtr &issuing_inst, OpClass op_class,
+                          IssueStruct *i2e_info);
+
+    /** Adds an instruction to the ready list of its op class. */
+    void addToReadyList(const DynInstPtr &inst, OpClass op_class);
+
+    /**
+     * Wakes the instructions waiting on a register in the wakeup matrix,
+     * and returns the number of operands that became ready.
+     */
+    int wakeMatrixDependents(RegIndex reg);
+
     //////////////////////////////////////
     // Various parameters
     //////////////////////////////////////
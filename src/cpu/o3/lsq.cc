@@ -896,6 +896,11 @@ LSQ::SingleDataRequest::finish(const Fault &fault, const RequestPtr &request,
 
         LSQRequest::_inst->fault = fault;
         LSQRequest::_inst->translationCompleted(true);
+
+        // The instruction is waiting in the IQ, which no longer keeps
+        // the CPU ticking for it.
+        if (isDelayed())
+            _inst->cpu->wakeCPU();
     }
 }
 
@@ -942,6 +947,9 @@ LSQ::SplitDataRequest::finish(const Fault &fault, const RequestPtr &req,
                 _inst->fault = _fault[0];
                 setState(State::Fault);
             }
+
+            if (isDelayed())
+                _inst->cpu->wakeCPU();
         }
 
     }
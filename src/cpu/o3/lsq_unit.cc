@@ -447,23 +447,25 @@ LSQUnit::checkSnoop(PacketPtr pkt)
 
     Addr invalidate_addr = pkt->getAddr() & cacheBlockMask;
 
-    DynInstPtr ld_inst = iter->instruction();
-    assert(ld_inst);
-    LSQRequest *request = iter->request();
+    const DynInstPtr &head_inst = iter->instruction();
+    assert(head_inst);
 
     // Check that this snoop didn't just invalidate our lock flag
-    if (ld_inst->effAddrValid() &&
-        request->isCacheBlockHit(invalidate_addr, cacheBlockMask)
-        && ld_inst->memReqFlags & Request::LLSC) {
-        ld_inst->tcBase()->getIsaPtr()->handleLockedSnoopHit(ld_inst.get());
+    if (head_inst->effAddrValid() &&
+        iter->request()->isCacheBlockHit(invalidate_addr, cacheBlockMask)
+        && head_inst->memReqFlags & Request::LLSC) {
+        head_inst->tcBase()->getIsaPtr()->handleLockedSnoopHit(
+                head_inst.get());
     }
 
     bool force_squash = false;
 
     while (++iter != loadQueue.end()) {
-        ld_inst = iter->instruction();
+        // Don't copy the instruction pointer, this loop walks the whole
+        // load queue and doesn't need to hold a reference.
+        const DynInstPtr &ld_inst = iter->instruction();
         assert(ld_inst);
-        request = iter->request();
+        LSQRequest *request = iter->request();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered())
             continue;
 
@@ -520,7 +522,8 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
      * like the implementation that came before it, we're overly conservative.
      */
     while (loadIt != loadQueue.end()) {
-        DynInstPtr ld_inst = loadIt->instruction();
+        // Avoid reference counting every load of the queue.
+        const DynInstPtr &ld_inst = loadIt->instruction();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
             ++loadIt;
             continue;
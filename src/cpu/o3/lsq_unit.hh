@@ -352,11 +352,14 @@ class LSQUnit
     bool
     willWB()
     {
+        // With TSO only one store can be in flight, and its completion
+        // wakes the CPU up, so don't keep IEW active while waiting for it.
         return storeWBIt.dereferenceable() &&
                         storeWBIt->valid() &&
                         storeWBIt->canWB() &&
                         !storeWBIt->completed() &&
-                        !isStoreBlocked;
+                        !isStoreBlocked &&
+                        (!needsTSO || !storeInFlight);
     }
 
     /** Handles doing the retry. */
@@ -409,7 +412,7 @@ class LSQUnit
     RequestPort *dcachePort;
 
     /** Writeback event, specifically for when stores forward data to loads. */
-    class WritebackEvent : public Event
+    class WritebackEvent : public Event, public EventPoolAllocated
     {
       public:
         /** Constructs a writeback event. */
@@ -41,6 +41,7 @@
 #include "cpu/o3/rob.hh"
 
 #include <list>
+#include <utility>
 
 #include "base/logging.hh"
 #include "cpu/o3/dyn_inst.hh"
@@ -97,6 +98,12 @@ ROB::ROB(CPU *_cpu, const BaseO3CPUParams &params)
         maxEntries[tid] = 0;
     }
 
+    // Whatever the policy, a thread never has more than numEntries
+    // instructions in the ROB.
+    instList.reserve(MaxThreads);
+    for (ThreadID tid = 0; tid < MaxThreads; tid++)
+        instList.emplace_back(tid < numThreads ? numEntries : 0);
+
     resetState();
 }
 
@@ -105,7 +112,7 @@ ROB::resetState()
 {
     for (ThreadID tid = 0; tid  < MaxThreads; tid++) {
         threadEntries[tid] = 0;
-        squashIt[tid] = instList[tid].end();
+        squashIt[tid] = InstIt();
         squashedSeqNum[tid] = 0;
         doneSquashing[tid] = true;
     }
@@ -113,8 +120,8 @@ ROB::resetState()
 
     // Initialize the "universal" ROB head & tail point to invalid
     // pointers
-    head = instList[0].end();
-    tail = instList[0].end();
+    head = InstIt();
+    tail = InstIt();
 }
 
 std::string
@@ -206,6 +213,9 @@ ROB::insertInst(const DynInstPtr &inst)
 
     ThreadID tid = inst->threadNumber;
 
+    panic_if(instList[tid].full(),
+             "[tid:%i] ROB instruction list overflow at [sn:%llu].",
+             tid, inst->seqNum);
     instList[tid].push_back(inst);
 
     //Set Up head iterator if this is the 1st instruction in the ROB
@@ -214,10 +224,7 @@ ROB::insertInst(const DynInstPtr &inst)
         assert((*head) == inst);
     }
 
-    //Must Decrement for iterator to actually be valid  since __.end()
-    //actually points to 1 after the last inst
-    tail = instList[tid].end();
-    tail--;
+    tail = instList[tid].getIterator(instList[tid].tail());
 
     inst->setInROB();
 
@@ -237,11 +244,10 @@ ROB::retireHead(ThreadID tid)
 
     assert(numInstsInROB > 0);
 
-    // Get the head ROB instruction by copying it and remove it from the list
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = std::move(*head_it);
-    instList[tid].erase(head_it);
+    // Get the head ROB instruction by moving it out of the list, so the
+    // slot doesn't keep it alive, and remove it from the list
+    DynInstPtr head_inst = std::move(instList[tid].front());
+    instList[tid].pop_front();
 
     assert(head_inst->readyToCommit());
 
@@ -312,13 +318,13 @@ ROB::doSquash(ThreadID tid)
     DPRINTF(ROB, "[tid:%i] Squashing instructions until [sn:%llu].\n",
             tid, squashedSeqNum[tid]);
 
-    assert(squashIt[tid] != instList[tid].end());
+    assert(squashIt[tid].dereferenceable());
 
     if ((*squashIt[tid])->seqNum < squashedSeqNum[tid]) {
         DPRINTF(ROB, "[tid:%i] Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
+        squashIt[tid] = InstIt();
 
         doneSquashing[tid] = true;
         return;
@@ -338,7 +344,6 @@ ROB::doSquash(ThreadID tid)
 
     for (int numSquashed = 0;
          numSquashed < numInstsToSquash &&
-         squashIt[tid] != instList[tid].end() &&
          (*squashIt[tid])->seqNum > squashedSeqNum[tid];
          ++numSquashed)
     {
@@ -358,17 +363,14 @@ ROB::doSquash(ThreadID tid)
             DPRINTF(ROB, "Reached head of instruction list while "
                     "squashing.\n");
 
-            squashIt[tid] = instList[tid].end();
+            squashIt[tid] = InstIt();
 
             doneSquashing[tid] = true;
 
             return;
         }
 
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
-
-        if ((*squashIt[tid]) == (*tail_thread))
+        if ((*squashIt[tid]) == instList[tid].back())
             robTailUpdate = true;
 
         squashIt[tid]--;
@@ -380,7 +382,7 @@ ROB::doSquash(ThreadID tid)
         DPRINTF(ROB, "[tid:%i] Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
+        squashIt[tid] = InstIt();
 
         doneSquashing[tid] = true;
     }
@@ -427,7 +429,7 @@ ROB::updateHead()
     }
 
     if (first_valid) {
-        head = instList[0].end();
+        head = InstIt();
     }
 
 }
@@ -435,7 +437,7 @@ ROB::updateHead()
 void
 ROB::updateTail()
 {
-    tail = instList[0].end();
+    tail = InstIt();
     bool first_valid = true;
 
     std::list<ThreadID>::iterator threads = activeThreads->begin();
@@ -450,17 +452,16 @@ ROB::updateTail()
 
         // If this is the first valid then assign w/out
         // comparison
+        InstIt tail_thread = instList[tid].getIterator(instList[tid].tail());
+
         if (first_valid) {
-            tail = instList[tid].end();
-            tail--;
+            tail = tail_thread;
             first_valid = false;
             continue;
         }
 
         // Assign new tail if this thread's tail is younger
         // than our current "tail high"
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
 
         if ((*tail_thread)->seqNum > (*tail)->seqNum) {
             tail = tail_thread;
@@ -489,10 +490,7 @@ ROB::squash(InstSeqNum squash_num, ThreadID tid)
     squashedSeqNum[tid] = squash_num;
 
     if (!instList[tid].empty()) {
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
-
-        squashIt[tid] = tail_thread;
+        squashIt[tid] = instList[tid].getIterator(instList[tid].tail());
 
         doSquash(tid);
     }
@@ -502,11 +500,11 @@ const DynInstPtr&
 ROB::readHeadInst(ThreadID tid)
 {
     if (threadEntries[tid] != 0) {
-        InstIt head_thread = instList[tid].begin();
+        const DynInstPtr &head_inst = instList[tid].front();
 
-        assert((*head_thread)->isInROB());
+        assert(head_inst->isInROB());
 
-        return *head_thread;
+        return head_inst;
     } else {
         return dummyInst;
     }
@@ -515,10 +513,7 @@ ROB::readHeadInst(ThreadID tid)
 DynInstPtr
 ROB::readTailInst(ThreadID tid)
 {
-    InstIt tail_thread = instList[tid].end();
-    tail_thread--;
-
-    return *tail_thread;
+    return instList[tid].back();
 }
 
 ROB::ROBStats::ROBStats(statistics::Group *parent)
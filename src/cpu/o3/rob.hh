@@ -45,6 +45,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
@@ -73,7 +74,7 @@ class ROB
 {
   public:
     typedef std::pair<RegIndex, RegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef typename CircularQueue<DynInstPtr>::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status
@@ -286,8 +287,13 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[MaxThreads];
 
-    /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /**
+     * ROB List of Instructions, one per thread. Instructions are only
+     * ever added at the tail and retired from the head (squashed
+     * instructions are retired like any other), so each list is a ring
+     * buffer with room for the whole ROB.
+     */
+    std::vector<CircularQueue<DynInstPtr>> instList;
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
@@ -295,7 +301,8 @@ class ROB
   public:
     /** Iterator pointing to the instruction which is the last instruction
      *  in the ROB.  This may at times be invalid (ie when the ROB is empty),
-     *  however it should never be incorrect.
+     *  however it should never be incorrect. It is default constructed
+     *  when invalid.
      */
     InstIt tail;
 
@@ -309,7 +316,7 @@ class ROB
      *  when squashing, the instructions are marked as squashed but not
      *  immediately removed, meaning the tail iterator remains the same before
      *  and after a squash.
-     *  This will always be set to cpu->instList.end() if it is invalid.
+     *  This will always be default constructed if it is invalid.
      */
     InstIt squashIt[MaxThreads];
 
@@ -0,0 +1,538 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_WAKEUP_MATRIX_HH__
+#define __CPU_O3_WAKEUP_MATRIX_HH__
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/op_class.hh"
+#include "cpu/reg_class.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Table of instruction slots shared by the wakeup matrix and the ready
+ * bitmaps. A slot holds a reference to an instruction while it is
+ * tracked by one of them, so that the bitmaps only need to store slot
+ * numbers. The table grows in chunks of 64 slots if it ever runs out.
+ */
+template <class DynInstPtr>
+class InstSlotTable
+{
+  public:
+    /** Take a free slot for an instruction. */
+    int
+    allocate(const DynInstPtr &inst)
+    {
+        if (freeSlots.empty())
+            grow();
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        insts[slot] = inst;
+        return slot;
+    }
+
+    /** Return a slot to the free list, dropping its instruction. */
+    void
+    release(int slot)
+    {
+        insts[slot] = nullptr;
+        freeSlots.push_back(slot);
+    }
+
+    const DynInstPtr &operator[](int slot) const { return insts[slot]; }
+
+    /** Number of slots, always a multiple of 64. */
+    int size() const { return insts.size(); }
+
+    /** Number of 64 bit words needed for a bitmap over all the slots. */
+    int words() const { return insts.size() / 64; }
+
+    /** Release all the slots. */
+    void clear();
+
+    /** Make room for at least num_slots slots. */
+    void reserve(int num_slots);
+
+  private:
+    void grow() { reserve(size() + 64); }
+
+    std::vector<DynInstPtr> insts;
+    std::vector<int> freeSlots;
+};
+
+/**
+ * Register wakeup matrix, a drop-in replacement for DependencyGraph.
+ *
+ * Instead of a linked list of dependents per physical register, every
+ * register has a row of bits with one column per instruction slot. An
+ * instruction waiting on several registers takes a single slot and sets
+ * its column in each of their rows; waking a register clears its row and
+ * returns the instructions of the set columns one at a time. An
+ * instruction waiting on the same register through several operands has
+ * a single bit in that row, so the caller is responsible for marking all
+ * of those operands ready.
+ */
+template <class DynInstPtr>
+class WakeupMatrix
+{
+  public:
+    /** Resize the matrix to have num_regs rows and clear it. */
+    void resize(int num_regs, int num_slots);
+
+    /** Clears the whole matrix. */
+    void reset();
+
+    /** Take a slot for an instruction that has to wait on registers. */
+    int allocate(const DynInstPtr &inst) { return slots.allocate(inst); }
+
+    /** Makes the instruction in a slot wait on a register. */
+    void insert(RegIndex reg, int slot);
+
+    /** Stops an instruction from waiting on a register, if it does. */
+    void remove(RegIndex reg, const DynInstPtr &inst);
+
+    /**
+     * Removes and returns an instruction waiting on a register, or
+     * nullptr if there are none left.
+     */
+    DynInstPtr pop(RegIndex reg);
+
+    /** Checks if the entire matrix is empty. */
+    bool empty() const { return numWaiting == 0; }
+
+    /** Checks if there are any dependents on a specific register. */
+    bool empty(RegIndex reg) const;
+
+    /** Debugging function to dump out the matrix. */
+    void dump() const;
+
+  private:
+    uint64_t *row(RegIndex reg) { return &bits[reg * stride]; }
+    const uint64_t *row(RegIndex reg) const { return &bits[reg * stride]; }
+
+    /** Clear a column of a row, releasing the slot if it was its last. */
+    void clearBit(RegIndex reg, int slot);
+
+    /** Make room for the columns of all the slots of the table. */
+    void growColumns();
+
+    InstSlotTable<DynInstPtr> slots;
+
+    /** Number of registers each slot is still waiting on. */
+    std::vector<uint8_t> pending;
+
+    /** numRegs rows of stride words. */
+    std::vector<uint64_t> bits;
+
+    int numRegs = 0;
+    int stride = 0;
+
+    /** Number of slots in use. */
+    int numWaiting = 0;
+};
+
+/**
+ * Age ordered sets of ready instructions, one per op class.
+ *
+ * Each op class has a bitmap over instruction slots, and the slot of its
+ * oldest instruction is cached so that picking the oldest ready
+ * instruction among a set of op classes only looks at one entry per
+ * class. This replaces the per op class priority queues and the list
+ * that kept them sorted by their oldest instruction.
+ */
+template <class DynInstPtr>
+class ReadyBitmap
+{
+  public:
+    static constexpr int ClassWords = divCeil(int(Num_OpClasses), 64);
+
+    /** A set of op classes. */
+    typedef std::array<uint64_t, ClassWords> ClassMask;
+
+    /** Prepare for up to num_slots ready instructions and clear. */
+    void resize(int num_slots);
+
+    /** Removes all the instructions. */
+    void reset();
+
+    /** Adds an instruction to the ready set of an op class. */
+    void push(const DynInstPtr &inst, OpClass op_class);
+
+    /**
+     * Slot of the oldest ready instruction among the op classes that are
+     * not blocked, or -1 if there is none.
+     */
+    int oldest(const ClassMask &blocked) const;
+
+    /** Removes the instruction of a slot returned by oldest(). */
+    void pop(int slot);
+
+    const DynInstPtr &inst(int slot) const { return slots[slot]; }
+    OpClass opClass(int slot) const { return slotClass[slot]; }
+
+    bool empty() const { return numReady == 0; }
+
+    /** Number of ready instructions of an op class. */
+    int size(OpClass op_class) const;
+
+    static void
+    block(ClassMask &mask, OpClass op_class)
+    {
+        mask[op_class / 64] |= 1ULL << (op_class % 64);
+    }
+
+  private:
+    uint64_t *classBits(OpClass op_class)
+    {
+        return &bits[op_class * stride];
+    }
+
+    const uint64_t *classBits(OpClass op_class) const
+    {
+        return &bits[op_class * stride];
+    }
+
+    /** Rescan the bitmap of an op class for its oldest instruction. */
+    void findOldest(OpClass op_class);
+
+    /** Make room for the columns of all the slots of the table. */
+    void growColumns();
+
+    InstSlotTable<DynInstPtr> slots;
+
+    /** Sequence number and op class of the instruction of each slot. */
+    std::vector<InstSeqNum> slotSeq;
+    std::vector<OpClass> slotClass;
+
+    /** Num_OpClasses bitmaps of stride words. */
+    std::vector<uint64_t> bits;
+    int stride = 0;
+
+    /** Op classes with at least one ready instruction. */
+    ClassMask nonEmpty = {};
+
+    /** Slot of the oldest instruction of each op class. */
+    std::array<int, Num_OpClasses> oldestSlot;
+
+    int numReady = 0;
+};
+
+
+template <class DynInstPtr>
+void
+InstSlotTable<DynInstPtr>::clear()
+{
+    std::fill(insts.begin(), insts.end(), nullptr);
+    freeSlots.clear();
+    // Hand out the lowest slots first.
+    for (int slot = insts.size(); slot-- > 0;)
+        freeSlots.push_back(slot);
+}
+
+template <class DynInstPtr>
+void
+InstSlotTable<DynInstPtr>::reserve(int num_slots)
+{
+    int old_size = size();
+    int new_size = roundUp(num_slots, 64);
+    if (new_size <= old_size)
+        return;
+
+    insts.resize(new_size);
+    // Keep the lowest new slot at the back of the free list.
+    freeSlots.insert(freeSlots.begin(), new_size - old_size, 0);
+    for (int i = 0; i < new_size - old_size; i++)
+        freeSlots[i] = new_size - 1 - i;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::resize(int num_regs, int num_slots)
+{
+    numRegs = num_regs;
+    slots.reserve(num_slots);
+    stride = 0;
+    bits.clear();
+    growColumns();
+    reset();
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::reset()
+{
+    std::fill(bits.begin(), bits.end(), 0);
+    std::fill(pending.begin(), pending.end(), 0);
+    slots.clear();
+    numWaiting = 0;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::growColumns()
+{
+    int new_stride = slots.words();
+    if (new_stride == stride)
+        return;
+
+    std::vector<uint64_t> new_bits(numRegs * new_stride, 0);
+    for (int reg = 0; reg < numRegs; reg++) {
+        std::copy(bits.begin() + reg * stride,
+                  bits.begin() + (reg + 1) * stride,
+                  new_bits.begin() + reg * new_stride);
+    }
+    bits.swap(new_bits);
+    stride = new_stride;
+    pending.resize(slots.size(), 0);
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::insert(RegIndex reg, int slot)
+{
+    assert(reg < numRegs);
+    // The slot table may have grown when the slot was allocated.
+    if (slot >= stride * 64)
+        growColumns();
+
+    uint64_t &word = row(reg)[slot / 64];
+    const uint64_t mask = 1ULL << (slot % 64);
+    if (word & mask)
+        return;
+
+    word |= mask;
+    if (pending[slot]++ == 0)
+        numWaiting++;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::clearBit(RegIndex reg, int slot)
+{
+    row(reg)[slot / 64] &= ~(1ULL << (slot % 64));
+    assert(pending[slot]);
+    if (--pending[slot] == 0) {
+        slots.release(slot);
+        numWaiting--;
+    }
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::remove(RegIndex reg, const DynInstPtr &inst)
+{
+    const uint64_t *r = row(reg);
+    for (int w = 0; w < stride; w++) {
+        for (uint64_t word = r[w]; word; word &= word - 1) {
+            int slot = w * 64 + findLsbSet(word);
+            if (slots[slot] == inst) {
+                clearBit(reg, slot);
+                return;
+            }
+        }
+    }
+}
+
+template <class DynInstPtr>
+DynInstPtr
+WakeupMatrix<DynInstPtr>::pop(RegIndex reg)
+{
+    const uint64_t *r = row(reg);
+    for (int w = 0; w < stride; w++) {
+        if (r[w]) {
+            int slot = w * 64 + findLsbSet(r[w]);
+            DynInstPtr inst = slots[slot];
+            clearBit(reg, slot);
+            return inst;
+        }
+    }
+    return nullptr;
+}
+
+template <class DynInstPtr>
+bool
+WakeupMatrix<DynInstPtr>::empty(RegIndex reg) const
+{
+    const uint64_t *r = row(reg);
+    return std::all_of(r, r + stride, [](uint64_t word) { return !word; });
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::dump() const
+{
+    for (int reg = 0; reg < numRegs; reg++) {
+        cprintf("wakeupMatrix[%i]: consumer: ", reg);
+        const uint64_t *r = row(reg);
+        for (int w = 0; w < stride; w++) {
+            for (uint64_t word = r[w]; word; word &= word - 1) {
+                const DynInstPtr &inst = slots[w * 64 + findLsbSet(word)];
+                cprintf("%s [sn:%lli] ", inst->pcState(), inst->seqNum);
+            }
+        }
+        cprintf("\n");
+    }
+    cprintf("Waiting instructions: %i\n", numWaiting);
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::resize(int num_slots)
+{
+    slots.reserve(num_slots);
+    stride = 0;
+    bits.clear();
+    growColumns();
+    reset();
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::reset()
+{
+    std::fill(bits.begin(), bits.end(), 0);
+    nonEmpty.fill(0);
+    oldestSlot.fill(-1);
+    slots.clear();
+    numReady = 0;
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::growColumns()
+{
+    int new_stride = slots.words();
+    if (new_stride == stride)
+        return;
+
+    std::vector<uint64_t> new_bits(Num_OpClasses * new_stride, 0);
+    for (int op_class = 0; op_class < Num_OpClasses; op_class++) {
+        std::copy(bits.begin() + op_class * stride,
+                  bits.begin() + (op_class + 1) * stride,
+                  new_bits.begin() + op_class * new_stride);
+    }
+    bits.swap(new_bits);
+    stride = new_stride;
+    slotSeq.resize(slots.size(), 0);
+    slotClass.resize(slots.size(), No_OpClass);
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::push(const DynInstPtr &inst, OpClass op_class)
+{
+    int slot = slots.allocate(inst);
+    if (slot >= stride * 64)
+        growColumns();
+
+    slotSeq[slot] = inst->seqNum;
+    slotClass[slot] = op_class;
+    classBits(op_class)[slot / 64] |= 1ULL << (slot % 64);
+    numReady++;
+
+    int &oldest = oldestSlot[op_class];
+    if (oldest < 0 || slotSeq[slot] < slotSeq[oldest])
+        oldest = slot;
+    nonEmpty[op_class / 64] |= 1ULL << (op_class % 64);
+}
+
+template <class DynInstPtr>
+int
+ReadyBitmap<DynInstPtr>::oldest(const ClassMask &blocked) const
+{
+    int best = -1;
+    for (int w = 0; w < ClassWords; w++) {
+        for (uint64_t word = nonEmpty[w] & ~blocked[w]; word;
+                word &= word - 1) {
+            int slot = oldestSlot[w * 64 + findLsbSet(word)];
+            if (best < 0 || slotSeq[slot] < slotSeq[best])
+                best = slot;
+        }
+    }
+    return best;
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::findOldest(OpClass op_class)
+{
+    const uint64_t *b = classBits(op_class);
+    int best = -1;
+    for (int w = 0; w < stride; w++) {
+        for (uint64_t word = b[w]; word; word &= word - 1) {
+            int slot = w * 64 + findLsbSet(word);
+            if (best < 0 || slotSeq[slot] < slotSeq[best])
+                best = slot;
+        }
+    }
+
+    oldestSlot[op_class] = best;
+    if (best < 0)
+        nonEmpty[op_class / 64] &= ~(1ULL << (op_class % 64));
+}
+
+template <class DynInstPtr>
+void
+ReadyBitmap<DynInstPtr>::pop(int slot)
+{
+    OpClass op_class = slotClass[slot];
+    classBits(op_class)[slot / 64] &= ~(1ULL << (slot % 64));
+    slots.release(slot);
+    numReady--;
+
+    if (oldestSlot[op_class] == slot)
+        findOldest(op_class);
+}
+
+template <class DynInstPtr>
+int
+ReadyBitmap<DynInstPtr>::size(OpClass op_class) const
+{
+    const uint64_t *b = classBits(op_class);
+    int count = 0;
+    for (int w = 0; w < stride; w++)
+        count += popCount(b[w]);
+    return count;
+}
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_WAKEUP_MATRIX_HH__
@@ -0,0 +1,236 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "base/refcnt.hh"
+#include "cpu/o3/wakeup_matrix.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** The only part of an instruction the scheduler structures look at. */
+struct TestInst : public RefCounted
+{
+    TestInst(InstSeqNum seq_num) : seqNum(seq_num) {}
+    InstSeqNum seqNum;
+};
+
+typedef RefCountingPtr<TestInst> TestInstPtr;
+
+TestInstPtr
+makeInst(InstSeqNum seq_num)
+{
+    return TestInstPtr(new TestInst(seq_num));
+}
+
+} // anonymous namespace
+
+/** The oldest instruction of the op classes that aren't blocked wins. */
+TEST(ReadyBitmapTest, OldestWithBlockedMask)
+{
+    o3::ReadyBitmap<TestInstPtr> ready;
+    ready.resize(8);
+
+    ready.push(makeInst(5), IntAluOp);
+    ready.push(makeInst(3), FloatAddOp);
+    ready.push(makeInst(1), IntAluOp);
+    ready.push(makeInst(4), IntMultOp);
+
+    o3::ReadyBitmap<TestInstPtr>::ClassMask blocked = {};
+    int slot = ready.oldest(blocked);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(ready.inst(slot)->seqNum, 1);
+    EXPECT_EQ(ready.opClass(slot), IntAluOp);
+
+    o3::ReadyBitmap<TestInstPtr>::block(blocked, IntAluOp);
+    slot = ready.oldest(blocked);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(ready.inst(slot)->seqNum, 3);
+
+    o3::ReadyBitmap<TestInstPtr>::block(blocked, FloatAddOp);
+    slot = ready.oldest(blocked);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(ready.inst(slot)->seqNum, 4);
+
+    o3::ReadyBitmap<TestInstPtr>::block(blocked, IntMultOp);
+    EXPECT_EQ(ready.oldest(blocked), -1);
+
+    // Blocking doesn't change the contents.
+    EXPECT_EQ(ready.size(IntAluOp), 2);
+    EXPECT_FALSE(ready.empty());
+}
+
+/** Popping the oldest instruction of a class finds the next oldest. */
+TEST(ReadyBitmapTest, PopOldest)
+{
+    o3::ReadyBitmap<TestInstPtr> ready;
+    ready.resize(8);
+
+    ready.push(makeInst(7), IntAluOp);
+    ready.push(makeInst(2), IntAluOp);
+    ready.push(makeInst(9), IntAluOp);
+
+    const o3::ReadyBitmap<TestInstPtr>::ClassMask none = {};
+    std::vector<InstSeqNum> order;
+    for (int slot; (slot = ready.oldest(none)) >= 0;) {
+        order.push_back(ready.inst(slot)->seqNum);
+        ready.pop(slot);
+    }
+    EXPECT_EQ(order, std::vector<InstSeqNum>({2, 7, 9}));
+    EXPECT_TRUE(ready.empty());
+    EXPECT_EQ(ready.size(IntAluOp), 0);
+}
+
+/** The ready bitmaps keep working once the slot table had to grow. */
+TEST(ReadyBitmapTest, GrowPastNumEntries)
+{
+    o3::ReadyBitmap<TestInstPtr> ready;
+    ready.resize(4);
+
+    const int num_insts = 200;
+    for (int i = 0; i < num_insts; i++)
+        ready.push(makeInst(num_insts - i), i % 2 ? IntAluOp : FloatAddOp);
+    EXPECT_EQ(ready.size(IntAluOp), num_insts / 2);
+    EXPECT_EQ(ready.size(FloatAddOp), num_insts / 2);
+
+    const o3::ReadyBitmap<TestInstPtr>::ClassMask none = {};
+    for (int i = 1; i <= num_insts; i++) {
+        int slot = ready.oldest(none);
+        ASSERT_GE(slot, 0);
+        EXPECT_EQ(ready.inst(slot)->seqNum, i);
+        ready.pop(slot);
+    }
+    EXPECT_TRUE(ready.empty());
+}
+
+/** An instruction waiting on two registers wakes up on the last one. */
+TEST(WakeupMatrixTest, WaitOnTwoRegisters)
+{
+    o3::WakeupMatrix<TestInstPtr> matrix;
+    matrix.resize(4, 8);
+
+    TestInstPtr inst = makeInst(1);
+    int slot = matrix.allocate(inst);
+    matrix.insert(1, slot);
+    matrix.insert(2, slot);
+
+    EXPECT_EQ(matrix.pop(1), inst);
+    EXPECT_FALSE(matrix.pop(1));
+    EXPECT_TRUE(matrix.empty(1));
+    EXPECT_FALSE(matrix.empty(2));
+    EXPECT_FALSE(matrix.empty());
+
+    EXPECT_EQ(matrix.pop(2), inst);
+    EXPECT_TRUE(matrix.empty());
+}
+
+/**
+ * An instruction using the same register for two operands is returned
+ * once, and releases its slot when that register is woken up.
+ */
+TEST(WakeupMatrixTest, SameRegisterTwice)
+{
+    o3::WakeupMatrix<TestInstPtr> matrix;
+    matrix.resize(4, 8);
+
+    TestInstPtr inst = makeInst(1);
+    int slot = matrix.allocate(inst);
+    matrix.insert(3, slot);
+    matrix.insert(3, slot);
+
+    EXPECT_EQ(matrix.pop(3), inst);
+    EXPECT_FALSE(matrix.pop(3));
+    EXPECT_TRUE(matrix.empty());
+
+    // The slot is free again, and is the lowest one.
+    EXPECT_EQ(matrix.allocate(makeInst(2)), slot);
+}
+
+/** Removing a partially woken up instruction releases its slot. */
+TEST(WakeupMatrixTest, RemoveAfterPartialWakeup)
+{
+    o3::WakeupMatrix<TestInstPtr> matrix;
+    matrix.resize(4, 8);
+
+    TestInstPtr inst = makeInst(1);
+    TestInstPtr other = makeInst(2);
+    int slot = matrix.allocate(inst);
+    matrix.insert(0, slot);
+    matrix.insert(1, slot);
+    matrix.insert(1, matrix.allocate(other));
+
+    EXPECT_EQ(matrix.pop(0), inst);
+    EXPECT_FALSE(matrix.empty());
+
+    // Removing an instruction from a register it doesn't wait on does
+    // nothing.
+    matrix.remove(0, inst);
+    EXPECT_FALSE(matrix.empty(1));
+
+    matrix.remove(1, inst);
+    EXPECT_FALSE(matrix.empty(1));
+    EXPECT_EQ(matrix.allocate(makeInst(3)), slot);
+
+    EXPECT_EQ(matrix.pop(1), other);
+    EXPECT_FALSE(matrix.pop(1));
+}
+
+/** The matrix keeps its rows intact when the slot table grows. */
+TEST(WakeupMatrixTest, GrowPastNumEntries)
+{
+    o3::WakeupMatrix<TestInstPtr> matrix;
+    matrix.resize(2, 4);
+
+    const int num_insts = 200;
+    std::vector<TestInstPtr> insts;
+    for (int i = 0; i < num_insts; i++) {
+        insts.push_back(makeInst(i));
+        int slot = matrix.allocate(insts.back());
+        matrix.insert(i % 2, slot);
+        if (i % 4 == 0)
+            matrix.insert(1, slot);
+    }
+
+    int woken = 0;
+    for (TestInstPtr inst; (inst = matrix.pop(0));) {
+        EXPECT_EQ(inst->seqNum % 2, 0);
+        woken++;
+    }
+    EXPECT_EQ(woken, num_insts / 2);
+    EXPECT_FALSE(matrix.empty());
+
+    woken = 0;
+    for (TestInstPtr inst; (inst = matrix.pop(1));) {
+        EXPECT_TRUE(inst->seqNum % 2 || inst->seqNum % 4 == 0);
+        woken++;
+    }
+    EXPECT_EQ(woken, num_insts / 2 + num_insts / 4);
+    EXPECT_TRUE(matrix.empty());
+}
@@ -60,6 +60,10 @@ class BaseAtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    decoded_cache_entries = Param.Unsigned(0,
+            "Number of decoded instructions kept by each thread, to "
+            "execute them again without fetching and decoding them "
+            "(0 to disable)")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
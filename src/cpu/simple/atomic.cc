@@ -89,6 +89,14 @@ AtomicSimpleCPU::AtomicSimpleCPU(const BaseAtomicSimpleCPUParams &p)
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
     data_amo_req = std::make_shared<Request>();
+
+    if (p.decoded_cache_entries) {
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            blockCaches.push_back(std::make_unique<DecodedBlockCache>(
+                        p.decoded_cache_entries));
+        }
+        system->registerMemWriteListener(this);
+    }
 }
 
 
@@ -149,6 +157,11 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // The memory may have been changed behind our back, e.g. by a
+    // checkpoint restore or by another CPU model.
+    for (auto &cache : blockCaches)
+        cache->clear();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -272,7 +285,98 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
 Tick
 AtomicSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
-    return port.sendAtomic(pkt);
+    if (&port == &dcachePort && pkt->isWrite())
+        invalidateDecoded(pkt);
+
+    if (!system->bypassCaches())
+        return port.sendAtomic(pkt);
+
+    // A backdoor access takes no time, so the memory latency is only
+    // known when going through the memory system.
+    if (&port == &dcachePort && !simulate_data_stalls &&
+            accessBackdoor(pkt)) {
+        // The writes done through a backdoor never reach the memory,
+        // which would otherwise tell the other CPUs about them.
+        if (pkt->isWrite())
+            system->notifyMemWrite(pkt, this);
+        return 0;
+    }
+
+    MemBackdoorPtr bd = nullptr;
+    Tick latency = port.sendAtomicBackdoor(pkt, bd);
+
+    // If the target gave us a backdoor for next time and we didn't
+    // already have it, record it.
+    if (bd && memBackdoors.insert(bd->range(), bd) != memBackdoors.end()) {
+        // Install a callback to erase this backdoor if it goes away.
+        auto callback = [this](const MemBackdoor &backdoor) {
+                for (auto it = memBackdoors.begin();
+                        it != memBackdoors.end(); it++) {
+                    if (it->second == &backdoor) {
+                        memBackdoors.erase(it);
+                        return;
+                    }
+                }
+                panic("Got invalidation for unknown memory backdoor.");
+            };
+        bd->addInvalidationCallback(callback);
+    }
+    return latency;
+}
+
+bool
+AtomicSimpleCPU::threadsMonitoring() const
+{
+    for (auto *tc : system->threads) {
+        const AddressMonitor *monitor =
+            tc->getCpuPtr()->getCpuAddrMonitor(tc->threadId());
+        if (monitor->armed && monitor->waiting)
+            return true;
+    }
+    return false;
+}
+
+bool
+AtomicSimpleCPU::accessBackdoor(PacketPtr pkt)
+{
+    // LL/SC accesses have to reach the memory, which tracks the
+    // reservations and withdraws its backdoors while there are any.
+    const RequestPtr &req = pkt->req;
+    if (req->isLLSC() || req->isMasked())
+        return false;
+
+    auto bd_it = memBackdoors.contains(pkt->getAddrRange());
+    if (bd_it == memBackdoors.end())
+        return false;
+
+    MemBackdoorPtr bd = bd_it->second;
+    uint8_t *host_addr = bd->ptr() + (pkt->getAddr() - bd->range().start());
+
+    if (pkt->cmd == MemCmd::ReadReq) {
+        if (!bd->readable())
+            return false;
+        pkt->setData(host_addr);
+        return true;
+    }
+
+    // The other CPUs snoop the writes to wake up the threads waiting
+    // on a monitored address (e.g. x86 MWAIT).
+    if (!bd->writeable() || threadsMonitoring())
+        return false;
+
+    if (pkt->cmd == MemCmd::WriteReq) {
+        pkt->writeData(host_addr);
+        return true;
+    } else if (pkt->cmd == MemCmd::SwapReq && pkt->isAtomicOp() &&
+            bd->readable()) {
+        // Same as AbstractMemory::access(), the packet returns the old
+        // data.
+        pkt->setData(host_addr);
+        (*(pkt->getAtomicOp()))(host_addr);
+        return true;
+    }
+
+    return false;
 }
 
 Tick
@@ -301,6 +405,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
         }
+        cpu->invalidateDecoded(pkt);
     }
 
     return 0;
@@ -329,6 +434,80 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
                     cacheBlockMask);
         }
     }
+
+    if (pkt->isInvalidate() || pkt->isWrite())
+        cpu->invalidateDecoded(pkt);
+}
+
+DecodedBlockCache::Entry *
+AtomicSimpleCPU::lookupDecoded()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
+    DecodedBlockCache &cache = *blockCaches[curThread];
+
+    Addr inst_addr = thread->pcState().instAddr();
+
+    if (t_info.fetchOffset) {
+        // The instruction spans several fetches. Only keep it if it is
+        // contiguous in a single page, writes to the other page
+        // wouldn't invalidate it otherwise.
+        Addr end = ifetch_req->getPaddr() + ifetch_req->getSize() - 1;
+        if (ifetch_req->getPaddr() !=
+                fetchInstPaddr + (ifetch_req->getVaddr() - inst_addr) ||
+                !DecodedBlockCache::samePage(fetchInstPaddr, end)) {
+            fetchCacheable = false;
+        }
+        return nullptr;
+    }
+
+    cache.checkContext(thread->decoder->contextGen());
+
+    fetchInstPaddr = ifetch_req->getPaddr() +
+        (inst_addr - ifetch_req->getVaddr());
+    fetchCacheable = !ifetch_req->isUncacheable();
+    if (!fetchCacheable)
+        return nullptr;
+
+    DecodedBlockCache::Entry *entry =
+        cache.lookup(fetchInstPaddr, thread->pcState());
+    if (!entry)
+        set(fetchDecodePC, thread->pcState());
+    return entry;
+}
+
+void
+AtomicSimpleCPU::recordDecoded()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
+
+    if (!fetchCacheable || t_info.stayAtPC)
+        return;
+
+    const StaticInstPtr &inst =
+        curMacroStaticInst ? curMacroStaticInst : curStaticInst;
+    blockCaches[curThread]->insert(fetchInstPaddr, *fetchDecodePC, inst,
+                                   thread->pcState());
+}
+
+void
+AtomicSimpleCPU::invalidateDecoded(PacketPtr pkt)
+{
+    for (auto &cache : blockCaches)
+        cache->invalidate(pkt->getAddr(), pkt->getSize());
+}
+
+void
+AtomicSimpleCPU::threadFunctionalWrite(PacketPtr pkt)
+{
+    invalidateDecoded(pkt);
+}
+
+void
+AtomicSimpleCPU::unsnoopedWrite(PacketPtr pkt)
+{
+    invalidateDecoded(pkt);
 }
 
 bool
@@ -656,11 +835,19 @@ AtomicSimpleCPU::tick()
         const PCStateBase &pc = thread->pcState();
 
         bool needToFetch = !isRomMicroPC(pc.microPC()) && !curMacroStaticInst;
+        DecodedBlockCache::Entry *decoded = nullptr;
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
             fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
                                                  BaseMMU::Execute);
+
+            // An instruction decoded earlier at the same physical address
+            // doesn't need to be fetched and decoded again.
+            if (fault == NoFault && !blockCaches.empty()) {
+                decoded = lookupDecoded();
+                needToFetch = !decoded;
+            }
         }
 
         if (fault == NoFault) {
@@ -681,7 +868,13 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            if (decoded) {
+                preExecute(decoded->inst, *decoded->decodedPC);
+            } else {
+                preExecute();
+                if (needToFetch && !blockCaches.empty())
+                    recordDecoded();
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -41,8 +41,14 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+#include <vector>
+
+#include "base/addr_range_map.hh"
 #include "cpu/simple/base.hh"
+#include "cpu/simple/decoded_block_cache.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/BaseAtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -103,9 +109,62 @@ class AtomicSimpleCPU : public BaseSimpleCPU
      */
     bool tryCompleteDrain();
 
+    /**
+     * Backdoors to the memories, collected from the responses to our
+     * accesses when the memory system is in the 'atomic_noncaching' mode.
+     * In that mode no cache can hold newer data than the memories, so
+     * accesses can be done directly through the backdoors.
+     */
+    AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
+
+    /**
+     * Try to do a data access directly through a memory backdoor instead
+     * of sending it to the memory system. It is only used when the data
+     * stalls aren't simulated, as it takes no time. LL/SC and masked
+     * accesses, swaps, and accesses to addresses without a backdoor
+     * (e.g. devices) aren't handled.
+     *
+     * @return True if the access was done.
+     */
+    bool accessBackdoor(PacketPtr pkt);
+
+    /** Check if a thread of the system waits on a monitored address. */
+    bool threadsMonitoring() const;
+
     virtual Tick sendPacket(RequestPort &port, const PacketPtr &pkt);
     virtual Tick fetchInstMem();
 
+    /**
+     * Instructions decoded by each thread, empty if the CPU doesn't
+     * keep them around.
+     */
+    std::vector<std::unique_ptr<DecodedBlockCache>> blockCaches;
+
+    /** Physical address of the instruction being fetched. */
+    Addr fetchInstPaddr = 0;
+    /** Can the instruction being fetched be kept once decoded? */
+    bool fetchCacheable = false;
+    /** PC state of the instruction being fetched, before decoding. */
+    std::unique_ptr<PCStateBase> fetchDecodePC;
+
+    /**
+     * Look up the instruction the current thread is fetching, once the
+     * fetch request was translated.
+     *
+     * @return The decoded instruction, or nullptr if it has to be
+     * fetched and decoded.
+     */
+    DecodedBlockCache::Entry *lookupDecoded();
+
+    /** Keep the instruction the current thread just decoded. */
+    void recordDecoded();
+
+    /** Drop the decoded instructions a write may have modified. */
+    void invalidateDecoded(PacketPtr pkt);
+
+    void threadFunctionalWrite(PacketPtr pkt) override;
+    void unsnoopedWrite(PacketPtr pkt) override;
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
@@ -356,6 +356,40 @@ BaseSimpleCPU::preExecute()
         curStaticInst = curMacroStaticInst->fetchMicroop(pc_state.microPC());
     }
 
+    startInst();
+}
+
+void
+BaseSimpleCPU::preExecute(const StaticInstPtr &inst,
+                          const PCStateBase &decoded_pc)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
+    // resets predicates
+    t_info.setPredicate(true);
+    t_info.setMemAccPredicate(true);
+
+    assert(!curMacroStaticInst);
+    t_info.stayAtPC = false;
+    thread->pcState(decoded_pc);
+
+    if (inst->isMacroop()) {
+        curMacroStaticInst = inst;
+        curStaticInst = inst->fetchMicroop(decoded_pc.microPC());
+    } else {
+        curStaticInst = inst;
+    }
+
+    startInst();
+}
+
+void
+BaseSimpleCPU::startInst()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
     //If we decoded an instruction this "tick", record information about it.
     if (curStaticInst) {
 #if TRACING_ON
@@ -132,11 +132,26 @@ class BaseSimpleCPU : public BaseCPU
 
     std::unique_ptr<PCStateBase> preExecuteTempPC;
 
+    /**
+     * Set up the tracing and the branch prediction of the instruction
+     * about to be executed.
+     */
+    void startInst();
+
   public:
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
     void serviceInstCountEvents();
     void preExecute();
+
+    /**
+     * Same as preExecute(), but for an instruction that was decoded
+     * earlier instead of the one in the fetched bytes.
+     *
+     * @param inst The decoded instruction, possibly a macroop.
+     * @param decoded_pc The PC state the decoder produced for it.
+     */
+    void preExecute(const StaticInstPtr &inst, const PCStateBase &decoded_pc);
     void postExecute();
     void advancePC(const Fault &fault);
 
@@ -0,0 +1,109 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/decoded_block_cache.hh"
+
+namespace gem5
+{
+
+DecodedBlockCache::Entry *
+DecodedBlockCache::lookup(Addr paddr, const PCStateBase &pc)
+{
+    Entry *entry = nullptr;
+
+    // Straight-line code follows the chain without any hashing.
+    if (last && last->next && last->next->paddr == paddr) {
+        entry = last->next;
+    } else {
+        auto page_it = pages.find(pageOf(paddr));
+        if (page_it != pages.end()) {
+            auto it = page_it->second.find(paddr);
+            if (it != page_it->second.end())
+                entry = &it->second;
+        }
+    }
+
+    if (!entry || !entry->pc->equals(pc))
+        return nullptr;
+
+    if (last && last != entry && pageOf(last->paddr) == pageOf(paddr))
+        last->next = entry;
+    last = entry;
+    return entry;
+}
+
+DecodedBlockCache::Entry *
+DecodedBlockCache::insert(Addr paddr, const PCStateBase &pc,
+                          const StaticInstPtr &inst,
+                          const PCStateBase &decoded_pc)
+{
+    if (numEntries >= maxEntries)
+        clear();
+
+    auto [it, inserted] = pages[pageOf(paddr)].try_emplace(paddr);
+    if (inserted)
+        numEntries++;
+
+    Entry *entry = &it->second;
+    entry->paddr = paddr;
+    entry->inst = inst;
+    set(entry->pc, pc);
+    set(entry->decodedPC, decoded_pc);
+    entry->next = nullptr;
+
+    if (last && last != entry && pageOf(last->paddr) == pageOf(paddr))
+        last->next = entry;
+    last = entry;
+    return entry;
+}
+
+void
+DecodedBlockCache::invalidate(Addr paddr, Addr size)
+{
+    if (pages.empty() || size == 0)
+        return;
+
+    for (Addr page = pageOf(paddr); page <= pageOf(paddr + size - 1);
+            page += PageBytes) {
+        auto page_it = pages.find(page);
+        if (page_it == pages.end())
+            continue;
+
+        numEntries -= page_it->second.size();
+        pages.erase(page_it);
+        if (last && pageOf(last->paddr) == page)
+            last = nullptr;
+    }
+}
+
+void
+DecodedBlockCache::clear()
+{
+    pages.clear();
+    numEntries = 0;
+    last = nullptr;
+}
+
+} // namespace gem5
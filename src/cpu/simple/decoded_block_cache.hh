@@ -0,0 +1,130 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "arch/generic/pcstate.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+
+namespace gem5
+{
+
+/**
+ * Cache of pre-decoded instructions for the simple CPUs.
+ *
+ * Each entry remembers the instruction decoded at a physical address
+ * together with the PC state it was decoded with (which carries the ISA
+ * mode, e.g. Thumb or the IT state on Arm) and the PC state the decoder
+ * produced. Each entry is linked to the instruction that followed it,
+ * which chains the instructions of a basic block together: executing
+ * straight-line code only needs to check the next entry of the chain
+ * instead of fetching the instruction bytes and going through the
+ * decoder.
+ *
+ * Entries are grouped by physical page so that writes to memory, which
+ * may modify the code, drop the whole page. Chains never cross a page.
+ * The cache is also flushed whenever the context of the decoder (e.g.
+ * the x86 operating mode) changes.
+ */
+class DecodedBlockCache
+{
+  public:
+    struct Entry
+    {
+        Addr paddr;
+        StaticInstPtr inst;
+        /** PC state the instruction was decoded with. */
+        std::unique_ptr<PCStateBase> pc;
+        /** PC state after decoding the instruction. */
+        std::unique_ptr<PCStateBase> decodedPC;
+        /** Next instruction of the basic block, if known. */
+        Entry *next = nullptr;
+    };
+
+    /** Granularity of the invalidations, no larger than any ISA page. */
+    static constexpr Addr PageBytes = 4096;
+
+  private:
+    using Page = std::unordered_map<Addr, Entry>;
+    std::unordered_map<Addr, Page> pages;
+
+    const size_t maxEntries;
+    size_t numEntries = 0;
+
+    /** Decoder context generation the entries were decoded in. */
+    uint64_t contextGen = 0;
+
+    /** Last entry executed, used to link the blocks together. */
+    Entry *last = nullptr;
+
+    static Addr pageOf(Addr paddr) { return paddr & ~(PageBytes - 1); }
+
+  public:
+    DecodedBlockCache(size_t max_entries) : maxEntries(max_entries) {}
+
+    /** Are two physical addresses invalidated together? */
+    static bool samePage(Addr a, Addr b) { return pageOf(a) == pageOf(b); }
+
+    /**
+     * Look up the instruction at a physical address, which must have
+     * been decoded with the same PC state. The entry becomes the last
+     * executed one.
+     */
+    Entry *lookup(Addr paddr, const PCStateBase &pc);
+
+    /**
+     * Record a freshly decoded instruction and make it the last
+     * executed one.
+     */
+    Entry *insert(Addr paddr, const PCStateBase &pc,
+                  const StaticInstPtr &inst, const PCStateBase &decoded_pc);
+
+    /** Drop the entries of all the pages overlapping a range. */
+    void invalidate(Addr paddr, Addr size);
+
+    /** Flush the cache if the decoder context changed. */
+    void
+    checkContext(uint64_t gen)
+    {
+        if (gen != contextGen) {
+            clear();
+            contextGen = gen;
+        }
+    }
+
+    void clear();
+
+    size_t size() const { return numEntries; }
+};
+
+} // namespace gem5
+
+#endif // __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
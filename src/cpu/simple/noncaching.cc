@@ -62,31 +62,6 @@ NonCachingSimpleCPU::verifyMemoryMode() const
     }
 }
 
-Tick
-NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
-{
-    MemBackdoorPtr bd = nullptr;
-    Tick latency = port.sendAtomicBackdoor(pkt, bd);
-
-    // If the target gave us a backdoor for next time and we didn't
-    // already have it, record it.
-    if (bd && memBackdoors.insert(bd->range(), bd) != memBackdoors.end()) {
-        // Install a callback to erase this backdoor if it goes away.
-        auto callback = [this](const MemBackdoor &backdoor) {
-                for (auto it = memBackdoors.begin();
-                        it != memBackdoors.end(); it++) {
-                    if (it->second == &backdoor) {
-                        memBackdoors.erase(it);
-                        return;
-                    }
-                }
-                panic("Got invalidation for unknown memory backdoor.");
-            };
-        bd->addInvalidationCallback(callback);
-    }
-    return latency;
-}
-
 Tick
 NonCachingSimpleCPU::fetchInstMem()
 {
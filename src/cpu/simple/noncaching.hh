@@ -38,9 +38,7 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
-#include "base/addr_range_map.hh"
 #include "cpu/simple/atomic.hh"
-#include "mem/backdoor.hh"
 #include "params/BaseNonCachingSimpleCPU.hh"
 
 namespace gem5
@@ -58,9 +56,6 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
     void verifyMemoryMode() const override;
 
   protected:
-    AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
-
-    Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
     Tick fetchInstMem() override;
 };
 
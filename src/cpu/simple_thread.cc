@@ -52,6 +52,7 @@
 #include "cpu/base.hh"
 #include "cpu/simple/base.hh"
 #include "cpu/thread_context.hh"
+#include "mem/packet.hh"
 #include "mem/se_translating_port_proxy.hh"
 #include "mem/translating_port_proxy.hh"
 #include "params/BaseCPU.hh"
@@ -169,6 +170,14 @@ SimpleThread::copyArchRegs(ThreadContext *src_tc)
     getIsaPtr()->copyRegsFrom(src_tc);
 }
 
+void
+SimpleThread::sendFunctional(PacketPtr pkt)
+{
+    ThreadContext::sendFunctional(pkt);
+    if (pkt->isWrite())
+        baseCpu->threadFunctionalWrite(pkt);
+}
+
 // hardware transactional memory
 void
 SimpleThread::htmAbortTransaction(uint64_t htm_uid, HtmFailureFaultCause cause)
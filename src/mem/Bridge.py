@@ -58,3 +58,6 @@ class Bridge(ClockedObject):
     delay = Param.Latency('0ns', "The latency of this bridge")
     ranges = VectorParam.AddrRange([AllMemory],
                                    "Address ranges to pass through the bridge")
+
+    def minPortLatency(self):
+        return self.delay.getValue()
@@ -67,3 +67,6 @@ class SerialLink(ClockedObject):
         "link. (aka. lane width)")
     link_speed = Param.UInt64(1, "Gb/s Speed of each parallel lane inside the"
         "serial link. (aka. lane speed)")
+
+    def minPortLatency(self):
+        return self.delay.getValue()
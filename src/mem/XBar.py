@@ -95,6 +95,10 @@ class BaseXBar(ClockedObject):
     use_default_range = Param.Bool(False, "Perform address mapping for " \
                                        "the default port")
 
+    def minPortLatency(self):
+        return self.cyclesToTicks(min(int(self.frontend_latency),
+                                      int(self.response_latency)))
+
 class NoncoherentXBar(BaseXBar):
     type = 'NoncoherentXBar'
     cxx_header = "mem/noncoherent_xbar.hh"
@@ -130,6 +134,10 @@ class CoherentXBar(BaseXBar):
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
+    def minPortLatency(self):
+        return min(super().minPortLatency(),
+                   self.cyclesToTicks(self.snoop_response_latency))
+
 class SnoopFilter(SimObject):
     type = 'SnoopFilter'
     cxx_header = "mem/snoop_filter.hh"
@@ -472,6 +472,11 @@ AbstractMemory::access(PacketPtr pkt)
         panic("Unexpected packet %s", pkt->print());
     }
 
+    // The CPUs keeping decoded instructions don't snoop all the writes
+    // (e.g. DMA in the 'atomic_noncaching' mode), so tell them here.
+    if (pkt->isWrite() && _system)
+        _system->notifyMemWrite(pkt);
+
     if (pkt->needsResponse()) {
         pkt->makeResponse();
     }
@@ -495,6 +500,8 @@ AbstractMemory::functionalAccess(PacketPtr pkt)
             pkt->writeData(host_addr);
         }
         TRACE_PACKET("Write");
+        if (_system)
+            _system->notifyMemWrite(pkt);
         pkt->makeResponse();
     } else if (pkt->isPrint()) {
         Packet::PrintReqState *prs =
@@ -39,16 +39,23 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <set>
 #include <string>
+#include <thread>
 
 #include "base/intmath.hh"
 #include "base/trace.hh"
@@ -76,20 +83,209 @@ namespace gem5
 namespace memory
 {
 
+namespace
+{
+
+/** Upper bound on the threads writing a sparse memory checkpoint. */
+constexpr unsigned MaxCheckpointThreads = 16;
+
+bool
+isZero(const uint8_t *data, size_t len)
+{
+    // The pages are aligned, so the bulk can be checked a word at a time
+    size_t words = len / sizeof(uint64_t);
+    const uint64_t *w = reinterpret_cast<const uint64_t *>(data);
+    for (size_t i = 0; i < words; ++i) {
+        if (w[i])
+            return false;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < len; ++i) {
+        if (data[i])
+            return false;
+    }
+    return true;
+}
+
+bool
+writeFully(int fd, const uint8_t *data, size_t len, off_t offset)
+{
+    while (len > 0) {
+        ssize_t ret = pwrite(fd, data, len, offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += ret;
+        len -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+bool
+readFully(int fd, uint8_t *data, size_t len, off_t offset)
+{
+    while (len > 0) {
+        ssize_t ret = pread(fd, data, len, offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (ret == 0)
+            return false;
+        data += ret;
+        len -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+#if defined(__linux__)
+
+/** Soft-dirty bit of the entries of /proc/self/pagemap. */
+constexpr uint64_t SoftDirtyBit = 1ULL << 55;
+
+/** Clear the soft-dirty bits of all the pages of the process. */
+bool
+clearSoftDirty()
+{
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd == -1)
+        return false;
+    bool cleared = write(fd, "4", 1) == 1;
+    close(fd);
+    return cleared;
+}
+
+/** Read the soft-dirty bits of a range of pages of the process. */
+bool
+readSoftDirty(const uint8_t *start, uint64_t num_pages, long page_size,
+              std::vector<bool> &dirty)
+{
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    dirty.assign(num_pages, false);
+    const uint64_t first = (uintptr_t)start / page_size;
+    std::vector<uint64_t> entries(std::min<uint64_t>(num_pages, 1 << 16));
+    for (uint64_t done = 0; done < num_pages; done += entries.size()) {
+        uint64_t n = std::min<uint64_t>(entries.size(), num_pages - done);
+        if (!readFully(fd, (uint8_t *)entries.data(),
+                       n * sizeof(uint64_t),
+                       (first + done) * sizeof(uint64_t))) {
+            close(fd);
+            return false;
+        }
+        for (uint64_t i = 0; i < n; ++i)
+            dirty[done + i] = entries[i] & SoftDirtyBit;
+    }
+
+    close(fd);
+    return true;
+}
+
+/**
+ * Check that the kernel tracks the soft-dirty bits, since clearing them
+ * succeeds even when it does not.
+ */
+bool
+softDirtyAvailable()
+{
+    static const bool available = []() {
+        long page_size = sysconf(_SC_PAGE_SIZE);
+        uint8_t *page = (uint8_t *)mmap(NULL, page_size,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_ANON | MAP_PRIVATE, -1, 0);
+        if (page == (uint8_t *)MAP_FAILED)
+            return false;
+
+        std::vector<bool> dirty;
+        bool works = clearSoftDirty() &&
+            readSoftDirty(page, 1, page_size, dirty) && !dirty[0];
+        *(volatile uint8_t *)page = 1;
+        works = works && readSoftDirty(page, 1, page_size, dirty) && dirty[0];
+
+        munmap(page, page_size);
+        return works;
+    }();
+    return available;
+}
+
+#else
+
+bool clearSoftDirty() { return false; }
+bool softDirtyAvailable() { return false; }
+
+bool
+readSoftDirty(const uint8_t *start, uint64_t num_pages, long page_size,
+              std::vector<bool> &dirty)
+{
+    return false;
+}
+
+#endif
+
+std::string
+realPath(const std::string &path)
+{
+    char *resolved = realpath(path.c_str(), nullptr);
+    if (!resolved)
+        return path;
+    std::string result(resolved);
+    free(resolved);
+    return result;
+}
+
+/**
+ * Path of a checkpoint directory as recorded in another one: relative
+ * if they are in the same directory, so that the chain can be moved as
+ * a whole, and absolute otherwise.
+ */
+std::string
+checkpointPath(const std::string &target, const std::string &from)
+{
+    std::string target_path = realPath(target);
+    std::string from_path = realPath(from);
+    std::string target_parent =
+        target_path.substr(0, target_path.rfind('/'));
+    std::string from_parent = from_path.substr(0, from_path.rfind('/'));
+    if (target_parent == from_parent)
+        return "../" + target_path.substr(target_path.rfind('/') + 1);
+    return target_path;
+}
+
+/** Memories waiting for the dirty page tracking to be reset. */
+std::set<const PhysicalMemory *> pendingDeltaTracking;
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               MemoryCheckpointFormat checkpoint_format,
+                               unsigned max_delta_chain) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)), checkpointFormat(checkpoint_format),
+    maxDeltaChain(max_delta_chain), deltaChain(0), dirtyTracking(false)
 {
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
         registerExitCallback([=]() { shm_unlink(shared_backstore.c_str()); });
     }
 
+    static bool registered = false;
+    if (max_delta_chain > 0 && !registered) {
+        Serializable::postCheckpointCallbacks().push_back(
+                &PhysicalMemory::startPendingDeltaTracking);
+        registered = true;
+    }
+
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
 
@@ -264,6 +460,8 @@ PhysicalMemory::createBackingStore(
 
 PhysicalMemory::~PhysicalMemory()
 {
+    pendingDeltaTracking.erase(this);
+
     // unmap the backing store
     for (auto& s : backingStore)
         munmap((char*)s.pmem, s.range.size());
@@ -347,6 +545,11 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     SERIALIZE_CONTAINER(lal_addr);
     SERIALIZE_CONTAINER(lal_cid);
 
+    // a delta checkpoint needs the writes since its base to be tracked
+    const bool delta = dirtyTracking && deltaChain < maxDeltaChain;
+    unsigned delta_chain = delta ? deltaChain + 1 : 0;
+    SERIALIZE_SCALAR(delta_chain);
+
     // serialize the backing stores
     unsigned int nbr_of_stores = backingStore.size();
     SERIALIZE_SCALAR(nbr_of_stores);
@@ -355,18 +558,57 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     // store each backing store memory segment in a file
     for (auto& s : backingStore) {
         ScopedCheckpointSection sec(cp, csprintf("store%d", store_id));
-        serializeStore(cp, store_id++, s.range, s.pmem);
+        serializeStore(cp, store_id++, s.range, s.pmem, delta);
     }
+
+    if (maxDeltaChain > 0)
+        startDeltaTracking(CheckpointIn::dir(), delta_chain);
+}
+
+void
+PhysicalMemory::startDeltaTracking(const std::string &base,
+                                   unsigned chain) const
+{
+    deltaBase = realPath(base);
+    deltaChain = chain;
+    dirtyTracking = false;
+    pendingDeltaTracking.insert(this);
+}
+
+void
+PhysicalMemory::startPendingDeltaTracking()
+{
+    if (pendingDeltaTracking.empty())
+        return;
+
+    const bool tracking = softDirtyAvailable() && clearSoftDirty();
+    if (!tracking) {
+        warn_once("Host dirty page tracking is not available, memory "
+                  "checkpoints will not be deltas\n");
+    }
+    for (auto *pmem : pendingDeltaTracking)
+        pmem->dirtyTracking = tracking;
+    pendingDeltaTracking.clear();
 }
 
 void
 PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
-                               AddrRange range, uint8_t* pmem) const
+                               AddrRange range, uint8_t* pmem,
+                               bool delta) const
 {
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
+    const bool sparse = checkpointFormat == MemoryCheckpointFormat::sparse;
     std::string filename =
         name() + ".store" + std::to_string(store_id) + ".pmem";
+    std::string format = "gzip";
+    if (delta) {
+        filename += ".delta";
+        format = "delta";
+    } else if (sparse) {
+        filename += ".sparse";
+        format = "sparse";
+    }
     long range_size = range.size();
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
@@ -374,10 +616,23 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
 
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(format);
     SERIALIZE_SCALAR(range_size);
 
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    if (delta) {
+        std::string base = checkpointPath(deltaBase, CheckpointIn::dir());
+        long page_size = pageSize;
+        SERIALIZE_SCALAR(base);
+        SERIALIZE_SCALAR(page_size);
+        serializeDeltaStore(filepath, range, pmem);
+        return;
+    } else if (sparse) {
+        serializeSparseStore(filepath, range, pmem);
+        return;
+    }
+
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
@@ -406,6 +661,121 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
 
 }
 
+void
+PhysicalMemory::serializeSparseStore(const std::string &filepath,
+                                     AddrRange range, uint8_t* pmem) const
+{
+    // The store may be a private mapping of this very file if it was
+    // restored from this checkpoint, so replace the file rather than
+    // truncating it.
+    unlink(filepath.c_str());
+    int fd = open(filepath.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // Size the file first, so that the zero pages are holes
+    const uint64_t store_size = range.size();
+    const uint64_t file_size = roundUp(store_size, pageSize);
+    if (ftruncate(fd, file_size))
+        fatal("Can't resize physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t num_pages = file_size / pageSize;
+    const unsigned num_threads = std::max<uint64_t>(1, std::min<uint64_t>(
+            {std::thread::hardware_concurrency(), MaxCheckpointThreads,
+             num_pages}));
+
+    std::atomic<bool> failed(false);
+    auto write_pages = [&](uint64_t first, uint64_t last) {
+        // Write each run of consecutive non-zero pages at once
+        uint64_t run_start = last;
+        for (uint64_t page = first; page <= last; ++page) {
+            uint64_t offset = page * pageSize;
+            bool zero = page == last || isZero(pmem + offset,
+                    std::min<uint64_t>(pageSize, store_size - offset));
+            if (!zero && run_start == last) {
+                run_start = page;
+            } else if (zero && run_start != last) {
+                uint64_t start = run_start * pageSize;
+                uint64_t end = std::min<uint64_t>(offset, store_size);
+                if (!writeFully(fd, pmem + start, end - start, start))
+                    failed = true;
+                run_start = last;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const uint64_t pages_per_thread = divCeil(num_pages, num_threads);
+    for (uint64_t first = 0; first < num_pages; first += pages_per_thread) {
+        threads.emplace_back(write_pages, first,
+                std::min(first + pages_per_thread, num_pages));
+    }
+    for (auto &t : threads)
+        t.join();
+
+    if (failed)
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::serializeDeltaStore(const std::string &filepath,
+                                    AddrRange range, uint8_t* pmem) const
+{
+    const uint64_t store_size = range.size();
+    const uint64_t num_pages = divCeil(store_size, pageSize);
+    std::vector<bool> dirty;
+    if (!readSoftDirty(pmem, num_pages, pageSize, dirty))
+        fatal("Can't read the dirty pages of the physical memory\n");
+
+    unlink(filepath.c_str());
+    int fd = open(filepath.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    uint64_t num_dirty = 0;
+    off_t offset = 0;
+    for (uint64_t page = 0; page < num_pages; ) {
+        if (!dirty[page]) {
+            ++page;
+            continue;
+        }
+
+        uint64_t run = 1;
+        while (page + run < num_pages && dirty[page + run])
+            ++run;
+
+        const uint64_t start = page * pageSize;
+        const uint64_t len = std::min<uint64_t>(run * pageSize,
+                                                store_size - start);
+        const uint64_t header[2] = { page, run };
+        if (!writeFully(fd, (const uint8_t *)header, sizeof(header),
+                        offset) ||
+            !writeFully(fd, pmem + start, len, offset + sizeof(header))) {
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+        }
+
+        offset += sizeof(header) + len;
+        num_dirty += run;
+        page += run;
+    }
+
+    DPRINTF(Checkpoint, "Wrote %d dirty pages out of %d\n",
+            num_dirty, num_pages);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
 void
 PhysicalMemory::unserialize(CheckpointIn &cp)
 {
@@ -429,6 +799,16 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
         unserializeStore(cp);
     }
 
+    deltaBases.clear();
+
+    // Restoring only writes the pages of this memory, so the dirty pages
+    // of the memories already restored can be dropped right away.
+    unsigned delta_chain = 0;
+    UNSERIALIZE_OPT_SCALAR(delta_chain);
+    if (maxDeltaChain > 0) {
+        startDeltaTracking(cp.getCptDir(), delta_chain);
+        startPendingDeltaTracking();
+    }
 }
 
 void
@@ -443,6 +823,58 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
+    // checkpoints predating the sparse format do not record the format
+    std::string format = "gzip";
+    UNSERIALIZE_OPT_SCALAR(format);
+
+    if (format == "sparse") {
+        long range_size;
+        UNSERIALIZE_SCALAR(range_size);
+        const BackingStoreEntry &store = backingStore[store_id];
+        if (range_size != store.range.size())
+            fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+                  range_size, store.range.size());
+
+        DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d\n",
+                filename, range_size);
+
+        unserializeSparseStore(filepath, store);
+        return;
+    } else if (format == "delta") {
+        long range_size;
+        UNSERIALIZE_SCALAR(range_size);
+        const BackingStoreEntry &store = backingStore[store_id];
+        if (range_size != store.range.size())
+            fatal("Memory range size has changed! Saw %lld, expected %lld\n",
+                  range_size, store.range.size());
+
+        std::string base;
+        long page_size;
+        UNSERIALIZE_SCALAR(base);
+        UNSERIALIZE_SCALAR(page_size);
+        if (base[0] != '/')
+            base = cp.getCptDir() + "/" + base;
+
+        DPRINTF(Checkpoint, "Unserializing physical memory %s relative to "
+                "%s\n", filename, base);
+
+        // Restore the base checkpoint of the chain first. The store has
+        // the same section in all the checkpoints of the chain, and the
+        // base is only parsed once for all the stores.
+        auto &base_cp = deltaBases[base];
+        if (!base_cp)
+            base_cp = std::make_unique<CheckpointIn>(base);
+        unserializeStore(*base_cp);
+        // Loading a checkpoint changes the current checkpoint directory
+        CheckpointIn::setDir(cp.getCptDir());
+
+        unserializeDeltaStore(filepath, store, page_size);
+        return;
+    } else if (format != "gzip") {
+        fatal("Unknown format '%s' of physical memory checkpoint file '%s'\n",
+              format, filename);
+    }
+
     // mmap memoryfile
     gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
     if (compressed_mem == NULL)
@@ -491,5 +923,92 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
               filename);
 }
 
+void
+PhysicalMemory::unserializeSparseStore(const std::string &filepath,
+                                       const BackingStoreEntry &store)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'\n", filepath);
+
+    const uint64_t store_size = store.range.size();
+    struct stat st;
+    if (fstat(fd, &st) || (uint64_t)st.st_size < store_size)
+        fatal("Physical memory checkpoint file '%s' is truncated\n",
+              filepath);
+
+    if (store.shmFd == -1) {
+        // Map the file over the anonymous backing store. The mapping is
+        // private, so the pages are only read when touched and the writes
+        // of the simulation never reach the checkpoint.
+        int map_flags = MAP_PRIVATE | MAP_FIXED;
+        if (mmapUsingNoReserve)
+            map_flags |= MAP_NORESERVE;
+        void *pmem = mmap(store.pmem, store_size, PROT_READ | PROT_WRITE,
+                          map_flags, fd, 0);
+        if (pmem == MAP_FAILED) {
+            perror("mmap");
+            fatal("Could not map physical memory checkpoint file '%s'\n",
+                  filepath);
+        }
+        assert(pmem == store.pmem);
+    } else {
+        // A shared backing store must stay mapped to its shared memory
+        // segment, so read the contents in place. The shared memory is
+        // zero when created, so only the data regions need to be read.
+        off_t offset = 0;
+        while (offset < (off_t)store_size) {
+            off_t data = offset;
+            off_t hole = store_size;
+#ifdef SEEK_DATA
+            data = lseek(fd, offset, SEEK_DATA);
+            if (data == -1 || data >= (off_t)store_size)
+                break;
+            hole = std::min<off_t>(lseek(fd, data, SEEK_HOLE), store_size);
+            if (hole <= data)
+                hole = store_size;
+#endif
+            if (!readFully(fd, store.pmem + data, hole - data, data))
+                fatal("Read failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            offset = hole;
+        }
+    }
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::unserializeDeltaStore(const std::string &filepath,
+                                      const BackingStoreEntry &store,
+                                      long page_size)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+        fatal("Can't open physical memory checkpoint file '%s'\n", filepath);
+
+    const uint64_t store_size = store.range.size();
+    off_t offset = 0;
+    uint64_t header[2];
+    while (readFully(fd, (uint8_t *)header, sizeof(header), offset)) {
+        const uint64_t start = header[0] * page_size;
+        if (start >= store_size)
+            fatal("Corrupted physical memory checkpoint file '%s'\n",
+                  filepath);
+        const uint64_t len = std::min<uint64_t>(header[1] * page_size,
+                                                store_size - start);
+        if (!readFully(fd, store.pmem + start, len, offset + sizeof(header)))
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+        offset += sizeof(header) + len;
+    }
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
 } // namespace memory
 } // namespace gem5
@@ -39,11 +39,14 @@
 #define __MEM_PHYSICAL_HH__
 
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/addr_range.hh"
 #include "base/addr_range_map.hh"
+#include "enums/MemoryCheckpointFormat.hh"
 #include "mem/packet.hh"
 #include "sim/serialize.hh"
 
@@ -158,6 +161,25 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    // Format of the memory contents when checkpointing
+    const MemoryCheckpointFormat checkpointFormat;
+
+    // Maximum number of delta checkpoints chained to a full one, zero
+    // if delta checkpoints are disabled
+    const unsigned maxDeltaChain;
+
+    // Last checkpoint written or restored, which the next delta
+    // checkpoint is relative to, and its position in its chain
+    mutable std::string deltaBase;
+    mutable unsigned deltaChain;
+
+    // Whether the host dirty page tracking covers all the writes since
+    // the base checkpoint
+    mutable bool dirtyTracking;
+
+    // Base checkpoints of the delta stores being restored, by directory
+    std::map<std::string, std::unique_ptr<CheckpointIn>> deltaBases;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -191,7 +213,10 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   MemoryCheckpointFormat checkpoint_format=
+                       MemoryCheckpointFormat::gzip,
+                   unsigned max_delta_chain=0);
 
     /**
      * Unmap all the backing store we have used.
@@ -280,9 +305,48 @@ class PhysicalMemory : public Serializable
      * @param store_id Unique identifier of this backing store
      * @param range The address range of this backing store
      * @param pmem The host pointer to this backing store
+     * @param delta Only write the pages dirtied since the base checkpoint
      */
     void serializeStore(CheckpointOut &cp, unsigned int store_id,
-                        AddrRange range, uint8_t* pmem) const;
+                        AddrRange range, uint8_t* pmem,
+                        bool delta=false) const;
+
+    /**
+     * Write a backing store to a sparse file: the non-zero pages are
+     * written at their offset, in parallel, and the zero pages are left
+     * as holes.
+     */
+    void serializeSparseStore(const std::string &filepath,
+                              AddrRange range, uint8_t* pmem) const;
+
+    /**
+     * Write the pages of a backing store dirtied since the base
+     * checkpoint, as runs of consecutive pages preceded by their first
+     * page number and length.
+     */
+    void serializeDeltaStore(const std::string &filepath,
+                             AddrRange range, uint8_t* pmem) const;
+
+    /**
+     * Record the checkpoint just written or restored as the base of the
+     * next delta checkpoint. The pages written are tracked from the next
+     * call to startPendingDeltaTracking().
+     *
+     * @param base Directory of that checkpoint
+     * @param chain Number of delta checkpoints between it and the
+     * full checkpoint of its chain
+     */
+    void startDeltaTracking(const std::string &base,
+                            unsigned chain) const;
+
+    /**
+     * Start tracking the pages written from now on for all the memories
+     * waiting for it. The host dirty page tracking covers the whole
+     * process, so it is only reset once all the memories of the
+     * simulator have been serialized, otherwise the stores of the other
+     * systems would lose their dirty pages.
+     */
+    static void startPendingDeltaTracking();
 
     /**
      * Unserialize the memories in the system. As with the
@@ -296,6 +360,23 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(CheckpointIn &cp);
 
+    /**
+     * Restore a backing store from a sparse file. Private backing stores
+     * are replaced by a copy-on-write mapping of the file, so the pages are
+     * only read when touched. Shared backing stores are read in place,
+     * skipping the holes.
+     */
+    void unserializeSparseStore(const std::string &filepath,
+                                const BackingStoreEntry &store);
+
+    /**
+     * Apply the pages of a delta checkpoint file to a backing store
+     * holding the contents of its base checkpoint.
+     */
+    void unserializeDeltaStore(const std::string &filepath,
+                               const BackingStoreEntry &store,
+                               long page_size);
+
 };
 
 } // namespace memory
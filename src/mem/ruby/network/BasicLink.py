@@ -54,6 +54,10 @@ class BasicExtLink(BasicLink):
     int_node = Param.BasicRouter("ID of internal node")
     bandwidth_factor = 16 # only used by simple network
 
+    def lookaheadLinks(self):
+        return [(self.ext_node, self.int_node,
+                 self.int_node.cyclesToTicks(self.latency))]
+
 class BasicIntLink(BasicLink):
     type = 'BasicIntLink'
     cxx_header = "mem/ruby/network/BasicLink.hh"
@@ -68,3 +72,7 @@ class BasicIntLink(BasicLink):
 
     # only used by simple network
     bandwidth_factor = 16
+
+    def lookaheadLinks(self):
+        return [(self.src_node, self.dst_node,
+                 self.src_node.cyclesToTicks(self.latency))]
@@ -111,9 +111,7 @@ class RubySystem : public ClockedObject
     bool eventQueueEmpty() { return eventq->empty(); }
     void enqueueRubyEvent(Tick tick)
     {
-        auto e = new EventFunctionWrapper(
-            [this]{ processRubyEvent(); }, "RubyEvent");
-        schedule(e, tick);
+        scheduleCallback([this]{ processRubyEvent(); }, tick, "RubyEvent");
     }
 
   private:
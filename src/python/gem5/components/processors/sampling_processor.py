@@ -0,0 +1,138 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from ..boards.mem_mode import MemMode
+from ..boards.abstract_board import AbstractBoard
+from ..processors.simple_core import SimpleCore
+from ..processors.cpu_types import CPUTypes
+from .switchable_processor import SwitchableProcessor
+from ...isas import ISA
+
+from ...utils.override import *
+
+from typing import Optional
+
+
+class SamplingProcessor(SwitchableProcessor):
+    """
+    A processor for sampled simulation. It starts with atomic cores, used
+    for fast-forwarding and functional warming, and can switch to detailed
+    (timing, minor or O3) cores for detailed warmup and measurement.
+
+    The atomic cores access memory through the same cache hierarchy as the
+    detailed cores, so the caches stay warm between samples. When the
+    detailed cores have a branch predictor, the atomic cores use and train
+    that same predictor.
+    """
+
+    def __init__(
+        self,
+        detailed_core_type: CPUTypes,
+        num_cores: int,
+        isa: Optional[ISA] = None,
+        warm_branch_predictor: bool = True,
+    ) -> None:
+        """
+        :param detailed_core_type: The CPU type used for detailed warmup and
+        measurement.
+        :param num_cores: The number of cores.
+        :param isa: The ISA of the processor.
+        :param warm_branch_predictor: Whether the atomic cores should train
+        the branch predictor of the detailed cores.
+        """
+
+        if num_cores <= 0:
+            raise AssertionError("Number of cores must be a positive integer!")
+
+        if detailed_core_type not in (
+            CPUTypes.TIMING,
+            CPUTypes.MINOR,
+            CPUTypes.O3,
+        ):
+            raise AssertionError(
+                f"CPU type '{detailed_core_type.value}' is not a detailed "
+                "CPU type."
+            )
+
+        self._functional_key = "functional"
+        self._detailed_key = "detailed"
+        self._in_detailed = False
+
+        functional_cores = [
+            SimpleCore(cpu_type=CPUTypes.ATOMIC, core_id=i, isa=isa)
+            for i in range(num_cores)
+        ]
+        detailed_cores = [
+            SimpleCore(cpu_type=detailed_core_type, core_id=i, isa=isa)
+            for i in range(num_cores)
+        ]
+
+        # The timing CPU has no branch predictor by default
+        if warm_branch_predictor and detailed_core_type != CPUTypes.TIMING:
+            for functional, detailed in zip(functional_cores, detailed_cores):
+                detailed_cpu = detailed.get_simobject()
+                bpred = detailed_cpu.branchPred
+                # Parent the predictor to the detailed core before sharing
+                # it, it would otherwise be adopted by the atomic core.
+                detailed_cpu.branchPred = bpred
+                functional.get_simobject().branchPred = bpred
+
+        super().__init__(
+            switchable_cores={
+                self._functional_key: functional_cores,
+                self._detailed_key: detailed_cores,
+            },
+            starting_cores=self._functional_key,
+        )
+
+    @overrides(SwitchableProcessor)
+    def incorporate_processor(self, board: AbstractBoard) -> None:
+        super().incorporate_processor(board=board)
+
+        board.set_mem_mode(MemMode.ATOMIC)
+
+    def is_detailed(self) -> bool:
+        """Returns True if the detailed cores are switched in."""
+        return self._in_detailed
+
+    def switch_to_detailed(self) -> None:
+        """Switches to the detailed cores, if not already switched in."""
+        if not self._in_detailed:
+            self.switch_to_processor(self._detailed_key)
+            self._in_detailed = True
+
+    def switch_to_functional(self) -> None:
+        """Switches to the atomic cores, if not already switched in."""
+        if self._in_detailed:
+            self.switch_to_processor(self._functional_key)
+            self._in_detailed = False
+
+    def switch(self):
+        """Switches between the atomic and the detailed cores."""
+        if self._in_detailed:
+            self.switch_to_functional()
+        else:
+            self.switch_to_detailed()
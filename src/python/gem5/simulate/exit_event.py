@@ -43,6 +43,11 @@ class ExitEvent(Enum):
     FAIL = "fail"  # An exit because the simulation has failed.
     CHECKPOINT = "checkpoint"  # An exit to load a checkpoint.
     MAX_TICK = "max tick" # An exit due to a maximum tick value being met.
+    MAX_INSTS = "max insts" # An exit due to an instruction count being met.
+    SIMPOINT_BEGIN = "simpoint begins" # An exit at the start of a SimPoint.
+    STATS_CONVERGED = ( # An exit because the monitored stats converged.
+        "stats converged"
+    )
     USER_INTERRUPT = ( # An exit due to a user interrupt (e.g., cntr + c)
         "user interupt"
     )
@@ -73,6 +78,12 @@ class ExitEvent(Enum):
             return ExitEvent.EXIT
         elif exit_string == "simulate() limit reached":
             return ExitEvent.MAX_TICK
+        elif exit_string == "a thread reached the max instruction count":
+            return ExitEvent.MAX_INSTS
+        elif exit_string == "all threads reached the max instruction count":
+            return ExitEvent.MAX_INSTS
+        elif exit_string == "simpoint starting point found":
+            return ExitEvent.SIMPOINT_BEGIN
         elif exit_string == "switchcpu":
             return ExitEvent.SWITCHCPU
         elif exit_string == "m5_fail instruction encountered":
@@ -81,6 +92,8 @@ class ExitEvent(Enum):
             return ExitEvent.CHECKPOINT
         elif exit_string == "user interrupt received":
             return ExitEvent.USER_INTERRUPT
+        elif exit_string == "stats converged":
+            return ExitEvent.STATS_CONVERGED
         raise NotImplementedError(
             "Exit event '{}' not implemented".format(exit_string)
         )
@@ -74,3 +74,13 @@ def default_workend_generator():
     while True:
         m5.stats.dump()
         yield False
+
+
+def default_simpoint_generator():
+    """
+    A default generator for the start of a SimPoint. It will reset the
+    simulation statistics, so that they only cover the SimPoint.
+    """
+    while True:
+        m5.stats.reset()
+        yield False
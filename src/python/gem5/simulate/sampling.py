@@ -0,0 +1,316 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import m5
+from m5.util import inform
+
+import json
+import math
+import os
+import statistics
+from enum import Enum
+from typing import Dict, List, Optional
+
+from .simulator import Simulator
+from ..components.boards.abstract_board import AbstractBoard
+from ..components.processors.sampling_processor import SamplingProcessor
+
+
+class SamplingPhase(Enum):
+    FUNCTIONAL_WARMING = "functional warming"
+    DETAILED_WARMUP = "detailed warmup"
+    MEASUREMENT = "measurement"
+
+
+class SampledSimulator(Simulator):
+    """
+    A Simulator running a workload with systematic sampling, as in SMARTS
+    (Wunderlich et al., ISCA 2003).
+
+    The simulation repeatedly goes through three intervals, measured in
+    instructions committed by the first core:
+
+        * Functional warming: the atomic cores of the `SamplingProcessor`
+          run the workload, keeping the caches and the branch predictors
+          warm.
+        * Detailed warmup: the detailed cores are switched in and run to
+          fill their pipelines and queues. Nothing is measured.
+        * Measurement: the statistics are reset at the beginning and
+          dumped at the end of the interval, which gives one section of the
+          statistics file per sample.
+
+    The IPC of every sample is recorded, and the mean IPC, its confidence
+    interval and the number of samples needed for a target error are
+    reported in a JSON file of the output directory at the end of the run.
+
+    Other exit events are handled as in the `Simulator`. They must not
+    switch the cores, as the sampling relies on which cores are running.
+
+    Example
+    -------
+
+    ```
+    processor = SamplingProcessor(
+        detailed_core_type=CPUTypes.O3, num_cores=1, isa=ISA.X86
+    )
+    ...
+    simulator = SampledSimulator(
+        board=board,
+        functional_warming_insts=990000,
+        detailed_warmup_insts=2000,
+        measurement_insts=1000,
+    )
+    simulator.run()
+    print(simulator.get_ipc_estimate())
+    ```
+    """
+
+    # Cause of the exits scheduled at the end of the intervals
+    _interval_cause = "sampling interval reached"
+
+    def __init__(
+        self,
+        board: AbstractBoard,
+        functional_warming_insts: int,
+        detailed_warmup_insts: int,
+        measurement_insts: int,
+        max_samples: Optional[int] = None,
+        confidence: float = 0.997,
+        target_error: float = 0.03,
+        report_file: Optional[str] = "sampling.json",
+        **kwargs,
+    ) -> None:
+        """
+        :param board: The board to be simulated. Its processor must be a
+        `SamplingProcessor`.
+        :param functional_warming_insts: The length of the functional
+        warming interval, in instructions.
+        :param detailed_warmup_insts: The length of the detailed warmup
+        interval, in instructions.
+        :param measurement_insts: The length of the measurement interval, in
+        instructions.
+        :param max_samples: Stop the simulation after this many samples. If
+        None, the simulation runs until the workload exits.
+        :param confidence: The confidence level of the reported interval.
+        :param target_error: The relative error, at the given confidence
+        level, used to compute the number of samples needed.
+        :param report_file: The name of the report, in the output directory.
+        If None, no report is written.
+
+        The other parameters are passed to the `Simulator`.
+        """
+
+        super().__init__(board=board, **kwargs)
+
+        if not isinstance(board.get_processor(), SamplingProcessor):
+            raise Exception(
+                "Sampled simulation requires the board to use a "
+                "SamplingProcessor."
+            )
+        if functional_warming_insts < 0 or detailed_warmup_insts < 0:
+            raise Exception("Interval lengths cannot be negative.")
+        if measurement_insts <= 0:
+            raise Exception("The measurement interval cannot be empty.")
+        if not 0 < confidence < 1:
+            raise Exception("The confidence level must be in (0, 1).")
+
+        self._processor = board.get_processor()
+        self._interval_insts = {
+            SamplingPhase.FUNCTIONAL_WARMING: functional_warming_insts,
+            SamplingPhase.DETAILED_WARMUP: detailed_warmup_insts,
+            SamplingPhase.MEASUREMENT: measurement_insts,
+        }
+        self._max_samples = max_samples
+        self._confidence = confidence
+        self._target_error = target_error
+        self._report_file = report_file
+
+        self._phase = None
+        self._samples = []
+        self._measurement_start = None
+
+    def get_phase(self) -> Optional[SamplingPhase]:
+        """Returns the current sampling phase."""
+        return self._phase
+
+    def get_samples(self) -> List[Dict]:
+        """
+        Returns the samples measured so far. Each sample is a dictionary
+        with its starting tick, its length in ticks and cycles, the number
+        of instructions committed by all the cores and the IPC.
+        """
+        return self._samples
+
+    def get_ipc_estimate(self) -> Dict:
+        """
+        Returns the estimate of the IPC of the whole run from the samples:
+        the mean, the standard deviation and coefficient of variation of the
+        samples, the confidence interval of the mean, and the number of
+        samples needed to reach the target error.
+        """
+
+        ipcs = [sample["ipc"] for sample in self._samples]
+        estimate = {
+            "samples": len(ipcs),
+            "confidence": self._confidence,
+            "target_error": self._target_error,
+        }
+        if not ipcs:
+            return estimate
+
+        mean = statistics.mean(ipcs)
+        stdev = statistics.stdev(ipcs) if len(ipcs) > 1 else 0.0
+        cov = stdev / mean if mean else 0.0
+        z = statistics.NormalDist().inv_cdf((1 + self._confidence) / 2)
+        half_width = z * stdev / math.sqrt(len(ipcs))
+
+        estimate.update(
+            {
+                "ipc_mean": mean,
+                "ipc_stdev": stdev,
+                "ipc_cov": cov,
+                "ipc_ci_low": mean - half_width,
+                "ipc_ci_high": mean + half_width,
+                "relative_error": half_width / mean if mean else 0.0,
+                "samples_needed": math.ceil(
+                    (z * cov / self._target_error) ** 2
+                ),
+            }
+        )
+        return estimate
+
+    def _cores(self):
+        return [core.get_simobject() for core in self._processor.get_cores()]
+
+    def _total_insts(self) -> int:
+        return sum(cpu.totalInsts() for cpu in self._cores())
+
+    def _start_phase(self, phase: SamplingPhase) -> None:
+        """Switches the cores as needed and starts an interval."""
+
+        self._phase = phase
+        if phase == SamplingPhase.FUNCTIONAL_WARMING:
+            self._processor.switch_to_functional()
+        else:
+            self._processor.switch_to_detailed()
+
+        if phase == SamplingPhase.MEASUREMENT:
+            m5.stats.reset()
+            self._measurement_start = (
+                self.get_current_tick(),
+                self._total_insts(),
+            )
+
+        insts = self._interval_insts[phase]
+        if insts == 0:
+            self._end_phase()
+        else:
+            self._cores()[0].scheduleInstStop(0, insts, self._interval_cause)
+
+    def _end_phase(self) -> bool:
+        """
+        Ends the current interval and starts the next one.
+
+        :returns: True if enough samples have been measured.
+        """
+
+        if self._phase == SamplingPhase.FUNCTIONAL_WARMING:
+            self._start_phase(SamplingPhase.DETAILED_WARMUP)
+        elif self._phase == SamplingPhase.DETAILED_WARMUP:
+            self._start_phase(SamplingPhase.MEASUREMENT)
+        else:
+            self._record_sample()
+            if self._max_samples and len(self._samples) >= self._max_samples:
+                return True
+            self._start_phase(SamplingPhase.FUNCTIONAL_WARMING)
+        return False
+
+    def _record_sample(self) -> None:
+        m5.stats.dump()
+
+        start_tick, start_insts = self._measurement_start
+        ticks = self.get_current_tick() - start_tick
+        insts = self._total_insts() - start_insts
+        cycles = ticks / self._cores()[0].clk_domain.clockPeriod()
+        self._samples.append(
+            {
+                "start_tick": start_tick,
+                "ticks": ticks,
+                "cycles": cycles,
+                "insts": insts,
+                "ipc": insts / cycles if cycles else 0.0,
+            }
+        )
+
+    def _write_report(self) -> None:
+        estimate = self.get_ipc_estimate()
+        if estimate["samples"]:
+            inform(
+                "Sampled IPC: %.4f +/- %.4f (%.1f%% confidence, %d samples, "
+                "%d needed for %.1f%% error)"
+                % (
+                    estimate["ipc_mean"],
+                    estimate["ipc_ci_high"] - estimate["ipc_mean"],
+                    100 * self._confidence,
+                    estimate["samples"],
+                    estimate["samples_needed"],
+                    100 * self._target_error,
+                )
+            )
+
+        if self._report_file:
+            path = os.path.join(m5.options.outdir, self._report_file)
+            with open(path, "w") as f:
+                json.dump(
+                    {"estimate": estimate, "samples": self._samples},
+                    f,
+                    indent=4,
+                )
+
+    def run(self, max_ticks: int = m5.MaxTick) -> None:
+        """
+        Runs the sampled simulation until the workload exits, an exit event
+        generator returns True, or `max_samples` samples are measured, and
+        writes the report.
+
+        :param max_ticks: The maximum number of ticks per simulation run.
+        """
+
+        self._instantiate()
+
+        if self._phase is None:
+            self._start_phase(SamplingPhase.FUNCTIONAL_WARMING)
+
+        while True:
+            self._last_exit_event = m5.simulate(max_ticks)
+
+            if self.get_last_exit_event_cause() == self._interval_cause:
+                if self._end_phase():
+                    break
+            elif self._handle_exit_event():
+                break
+
+        self._write_report()
@@ -0,0 +1,307 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import m5
+from m5.util import fatal, inform
+
+import os
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Callable, List, Optional, Tuple
+
+from .simulator import Simulator
+from .exit_event import ExitEvent
+from ..components.boards.abstract_board import AbstractBoard
+from ..components.processors.cpu_types import CPUTypes
+from ..utils.simpoint import (
+    read_bbv,
+    read_simpoints,
+    reweight_stats,
+    select_simpoints,
+    write_simpoints,
+)
+
+
+class SimPointPipeline:
+    """
+    Runs a whole SimPoint flow from a single configuration script:
+
+        1. Profile: the workload runs on an atomic CPU which records a Basic
+           Block Vector (BBV) every `interval_insts` instructions.
+        2. Cluster: the BBVs are clustered and a representative interval
+           (SimPoint) and its weight are selected for each cluster.
+        3. Checkpoint: the workload runs again on an atomic CPU and a
+           checkpoint is taken `warmup_insts` instructions before every
+           SimPoint.
+        4. Regions: every SimPoint is restored from its checkpoint and
+           simulated on the detailed CPU, in parallel. The statistics are
+           reset after the warmup and dumped after the SimPoint.
+        5. Reweight: the statistics of the regions are combined with the
+           SimPoint weights into `stats.txt` in the output directory, which
+           has the usual format.
+
+    Each step runs in its own gem5 process, started by the first one with
+    the same script and arguments, as a gem5 process can only instantiate
+    one system. The outputs of step N are in `<outdir>/simpoint/<step>`.
+
+    Only the first core is profiled, so the pipeline is meant for
+    single-threaded workloads.
+
+    Example
+    -------
+
+    ```
+    def build_board(cpu_type: CPUTypes) -> AbstractBoard:
+        processor = SimpleProcessor(cpu_type=cpu_type, num_cores=1)
+        board = SimpleBoard(processor=processor, ...)
+        board.set_se_binary_workload(...)
+        return board
+
+    SimPointPipeline(
+        build_board=build_board,
+        detailed_cpu_type=CPUTypes.O3,
+        interval_insts=10_000_000,
+        warmup_insts=1_000_000,
+    ).run()
+    ```
+    """
+
+    _phase_env = "GEM5_SIMPOINT_PHASE"
+    _region_env = "GEM5_SIMPOINT_REGION"
+
+    def __init__(
+        self,
+        build_board: Callable[[CPUTypes], AbstractBoard],
+        detailed_cpu_type: CPUTypes = CPUTypes.O3,
+        interval_insts: int = 10_000_000,
+        warmup_insts: int = 1_000_000,
+        max_clusters: int = 30,
+        num_jobs: Optional[int] = None,
+        gem5_args: Optional[List[str]] = None,
+    ) -> None:
+        """
+        :param build_board: A function returning the board to simulate, with
+        its workload set, using cores of the given type.
+        :param detailed_cpu_type: The CPU type used to simulate the regions.
+        :param interval_insts: The number of instructions of an interval.
+        :param warmup_insts: The number of instructions simulated in detail
+        before each SimPoint to warm up the microarchitectural state.
+        :param max_clusters: The maximum number of SimPoints.
+        :param num_jobs: The number of regions simulated in parallel. By
+        default, the number of host CPUs.
+        :param gem5_args: Additional gem5 options passed to the processes of
+        the steps (e.g., `--debug-flags`).
+        """
+
+        if interval_insts <= 0:
+            fatal("The SimPoint interval must be a positive count.")
+
+        self._build_board = build_board
+        self._detailed_cpu_type = detailed_cpu_type
+        self._interval_insts = interval_insts
+        self._warmup_insts = warmup_insts
+        self._max_clusters = max_clusters
+        self._num_jobs = num_jobs or os.cpu_count() or 1
+        self._gem5_args = list(gem5_args or [])
+
+    def run(self) -> None:
+        """
+        Runs the pipeline, or the step of the pipeline this process has been
+        started for.
+        """
+
+        phase = os.environ.get(self._phase_env)
+        if phase is None:
+            self._run_driver()
+        elif phase == "profile":
+            self._run_profile()
+        elif phase == "checkpoint":
+            self._run_checkpoint()
+        elif phase == "region":
+            self._run_region(int(os.environ[self._region_env]))
+        else:
+            fatal(f"Unknown SimPoint pipeline phase '{phase}'.")
+
+    def _step_dir(self, step: str) -> Path:
+        # The steps are started with their own output directory, always
+        # below the one of the driver.
+        if os.environ.get(self._phase_env) is None:
+            root = Path(m5.options.outdir)
+        else:
+            root = Path(m5.options.outdir).parent.parent
+        return root / "simpoint" / step
+
+    def _simpoints_paths(self) -> Tuple[Path, Path]:
+        cluster_dir = self._step_dir("cluster")
+        return (
+            cluster_dir / "simpoints.simpts",
+            cluster_dir / "simpoints.weights",
+        )
+
+    def _region_start(self, interval: int) -> Tuple[int, int]:
+        """
+        :returns: The instruction count of the checkpoint of a SimPoint and
+        the number of warmup instructions after the checkpoint.
+        """
+        start = interval * self._interval_insts
+        warmup = min(self._warmup_insts, start)
+        return start - warmup, warmup
+
+    def _spawn(self, phase: str, outdir: Path, region: int = -1):
+        """Starts a gem5 process running a step of the pipeline."""
+
+        try:
+            gem5 = os.readlink("/proc/self/exe")
+        except OSError:
+            gem5 = sys.executable
+
+        env = dict(os.environ)
+        env[self._phase_env] = phase
+        env[self._region_env] = str(region)
+        command = (
+            [gem5, "-d", str(outdir)]
+            + self._gem5_args
+            + [os.path.abspath(sys.argv[0])]
+            + sys.argv[1:]
+        )
+        return subprocess.run(
+            command,
+            env=env,
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.STDOUT,
+        )
+
+    def _run_driver(self) -> None:
+        inform("SimPoint pipeline: profiling the workload")
+        if self._spawn("profile", self._step_dir("profile")).returncode:
+            fatal("The SimPoint profiling step failed.")
+
+        inform("SimPoint pipeline: selecting the SimPoints")
+        bbvs = read_bbv(str(self._step_dir("profile") / "simpoint.bb.gz"))
+        simpoints = select_simpoints(bbvs, max_k=self._max_clusters)
+        if not simpoints:
+            fatal("The workload did not complete a single interval.")
+        self._step_dir("cluster").mkdir(parents=True, exist_ok=True)
+        write_simpoints(simpoints, *map(str, self._simpoints_paths()))
+        inform(
+            f"SimPoint pipeline: {len(simpoints)} SimPoints out of "
+            f"{len(bbvs)} intervals"
+        )
+
+        if any(self._region_start(i)[0] > 0 for i, _ in simpoints):
+            inform("SimPoint pipeline: taking the checkpoints")
+            result = self._spawn("checkpoint", self._step_dir("checkpoint"))
+            if result.returncode:
+                fatal("The SimPoint checkpointing step failed.")
+
+        inform("SimPoint pipeline: simulating the SimPoints")
+        region_dirs = [
+            self._step_dir(f"region{n}") for n in range(len(simpoints))
+        ]
+        with ThreadPoolExecutor(max_workers=self._num_jobs) as pool:
+            results = list(
+                pool.map(
+                    lambda n: self._spawn("region", region_dirs[n], n),
+                    range(len(simpoints)),
+                )
+            )
+        for n, result in enumerate(results):
+            if result.returncode:
+                fatal(f"The simulation of SimPoint {n} failed.")
+
+        # Replace the stats file of this process rather than truncating it,
+        # as it is still open.
+        stats_path = Path(m5.options.outdir) / "stats.txt"
+        tmp_path = stats_path.with_suffix(".tmp")
+        reweight_stats(
+            [
+                (str(region_dirs[n] / "stats.txt"), weight)
+                for n, (_, weight) in enumerate(simpoints)
+            ],
+            str(tmp_path),
+        )
+        os.replace(tmp_path, stats_path)
+        inform(f"SimPoint pipeline: weighted statistics in {stats_path}")
+
+    def _first_cpu(self, board: AbstractBoard):
+        return board.get_processor().get_cores()[0].get_simobject()
+
+    def _run_profile(self) -> None:
+        board = self._build_board(CPUTypes.ATOMIC)
+        self._first_cpu(board).addSimPointProbe(self._interval_insts)
+        Simulator(board=board).run()
+
+    def _run_checkpoint(self) -> None:
+        simpoints = read_simpoints(*map(str, self._simpoints_paths()))
+        starts = sorted(
+            {
+                self._region_start(interval)[0]
+                for interval, _ in simpoints
+                if self._region_start(interval)[0] > 0
+            }
+        )
+
+        board = self._build_board(CPUTypes.ATOMIC)
+        self._first_cpu(board).simpoint_start_insts = starts
+
+        outdir = Path(m5.options.outdir)
+
+        def take_checkpoints():
+            for start in starts:
+                m5.checkpoint(str(outdir / f"cpt.{start}"))
+                yield start == starts[-1]
+
+        Simulator(
+            board=board,
+            on_exit_event={ExitEvent.SIMPOINT_BEGIN: take_checkpoints()},
+        ).run()
+
+    def _run_region(self, region: int) -> None:
+        simpoints = read_simpoints(*map(str, self._simpoints_paths()))
+        interval, _ = simpoints[region]
+        start, warmup = self._region_start(interval)
+
+        board = self._build_board(self._detailed_cpu_type)
+        cpu = self._first_cpu(board)
+        if warmup > 0:
+            cpu.simpoint_start_insts = [warmup]
+        cpu.max_insts_any_thread = warmup + self._interval_insts
+
+        checkpoint = None
+        if start > 0:
+            checkpoint = self._step_dir("checkpoint") / f"cpt.{start}"
+
+        def end_region():
+            m5.stats.dump()
+            yield True
+
+        Simulator(
+            board=board,
+            checkpoint_path=checkpoint,
+            on_exit_event={ExitEvent.MAX_INSTS: end_region()},
+        ).run()
@@ -32,14 +32,25 @@ from m5.objects import Root
 from m5.util import warn
 
 import os
+import sys
+import traceback
 from pathlib import Path
-from typing import Optional, List, Tuple, Dict, Generator, Union
+from typing import (
+    Callable,
+    Optional,
+    List,
+    Tuple,
+    Dict,
+    Generator,
+    Union,
+)
 
 from .exit_event_generators import (
     default_exit_generator,
     default_switch_generator,
     default_workbegin_generator,
     default_workend_generator,
+    default_simpoint_generator,
 )
 from .exit_event import ExitEvent
 from ..components.boards.abstract_board import AbstractBoard
@@ -142,6 +153,9 @@ class Simulator:
             * ExitEvent.WORKEND: default_workend_list
             * ExitEvent.USER_INTERRUPT: default_exit_generator
             * ExitEvent.MAX_TICK: default_exit_generator()
+            * ExitEvent.MAX_INSTS: default_exit_generator()
+            * ExitEvent.SIMPOINT_BEGIN: default_simpoint_generator()
+            * ExitEvent.STATS_CONVERGED: default_exit_generator()
 
         These generators can be found in the `exit_event_generator.py` module.
 
@@ -167,6 +181,9 @@ class Simulator:
             ExitEvent.WORKEND: default_workend_generator(),
             ExitEvent.USER_INTERRUPT: default_exit_generator(),
             ExitEvent.MAX_TICK: default_exit_generator(),
+            ExitEvent.MAX_INSTS: default_exit_generator(),
+            ExitEvent.SIMPOINT_BEGIN: default_simpoint_generator(),
+            ExitEvent.STATS_CONVERGED: default_exit_generator(),
         }
 
         if on_exit_event:
@@ -315,54 +332,142 @@ class Simulator:
 
             self._last_exit_event = m5.simulate(max_ticks)
 
-            # Translate the exit event cause to the exit event enum.
-            exit_enum = ExitEvent.translate_exit_status(
-                self.get_last_exit_event_cause()
-            )
+            # If the generator returned True we will return from the Simulator
+            # run loop.
+            if self._handle_exit_event():
+                return
 
-            # Check to see the run is corresponding to the expected execution
-            # order (assuming this check is demanded by the user).
-            if self._expected_execution_order:
-                expected_enum = self._expected_execution_order[
-                    self._exit_event_count
-                ]
-                if exit_enum.value != expected_enum.value:
-                    raise Exception(
-                        f"Expected a '{expected_enum.value}' exit event but a "
-                        f"'{exit_enum.value}' exit event was encountered."
-                    )
-
-            # Record the current tick and exit event enum.
-            self._tick_stopwatch.append((exit_enum, self.get_current_tick()))
-
-            try:
-                # If the user has specified their own generator for this exit
-                # event, use it.
-                exit_on_completion = next(self._on_exit_event[exit_enum])
-            except StopIteration:
-                # If the user's generator has ended, throw a warning and use
-                # the default generator for this exit event.
-                warn(
-                    "User-specified generator for the exit event "
-                    f"'{exit_enum.value}' has ended. Using the default "
-                    "generator."
-                )
-                exit_on_completion = next(
-                    self._default_on_exit_dict[exit_enum]
-                )
-            except KeyError:
-                # If the user has not specified their own generator for this
-                # exit event, use the default.
-                exit_on_completion = next(
-                    self._default_on_exit_dict[exit_enum]
+    def fork_variants(
+        self,
+        variants: Dict[str, Callable[["Simulator"], None]],
+        max_ticks: int = m5.MaxTick,
+        num_jobs: Optional[int] = None,
+    ) -> Dict[str, int]:
+        """
+        Runs several variants of the simulation from the current state, each
+        in a forked copy of this process. The board is instantiated (and the
+        checkpoint, if any, restored) once, and every child then only pays
+        for its own simulation, which makes parameter sweeps from a common
+        checkpoint much cheaper than restoring the checkpoint for each point.
+
+        Each child resets the statistics, calls the function of its variant
+        with this Simulator, runs until an exit event generator returns
+        True, and exits. Its outputs are written to `<outdir>/<name>`.
+
+        The simulator is drained before forking, so the functions can only
+        change what may be changed at run time: e.g., switching to a set of
+        cores with a different branch predictor with a `SwitchableProcessor`,
+        or changing the exit event generators. Parameters of the SimObjects
+        cannot be changed.
+
+        Forking requires all the listeners (e.g., GDB and terminal ports) to
+        be disabled. This is done here if the board is not instantiated yet,
+        otherwise `m5.disableAllListeners()` must have been called before the
+        instantiation.
+
+        :param variants: The function configuring each variant, by name.
+        :param max_ticks: The maximum number of ticks of each simulation run
+        in the children, as in `run()`.
+        :param num_jobs: The maximum number of children running at the same
+        time. By default, the number of host CPUs.
+
+        :returns: The exit code of each child, by variant name.
+        """
+
+        if not self._instantiated and not m5.listenersDisabled():
+            m5.disableAllListeners()
+        self._instantiate()
+
+        # Run the startup of the SimObjects here rather than in every child.
+        m5.simulate(0)
+
+        num_jobs = num_jobs or os.cpu_count() or 1
+        running = {}
+        exit_codes = {}
+
+        def wait_one():
+            pid, status = os.wait()
+            if os.WIFEXITED(status):
+                exit_codes[running.pop(pid)] = os.WEXITSTATUS(status)
+            else:
+                exit_codes[running.pop(pid)] = -os.WTERMSIG(status)
+
+        for name, configure in variants.items():
+            while len(running) >= num_jobs:
+                wait_one()
+
+            simout = "%(parent)s/" + name.replace("%", "%%")
+            pid = m5.fork(simout)
+            if pid == 0:
+                try:
+                    m5.stats.reset()
+                    configure(self)
+                    self.run(max_ticks)
+                except BaseException:
+                    traceback.print_exc()
+                    sys.stderr.flush()
+                    os._exit(1)
+                sys.exit(0)
+
+            running[pid] = name
+
+        while running:
+            wait_one()
+
+        return exit_codes
+
+    def _handle_exit_event(self) -> bool:
+        """
+        Handles the last exit event by running the generator for its type.
+
+        :returns: True if the Simulator run loop should exit.
+        """
+
+        # Translate the exit event cause to the exit event enum.
+        exit_enum = ExitEvent.translate_exit_status(
+            self.get_last_exit_event_cause()
+        )
+
+        # Check to see the run is corresponding to the expected execution
+        # order (assuming this check is demanded by the user).
+        if self._expected_execution_order:
+            expected_enum = self._expected_execution_order[
+                self._exit_event_count
+            ]
+            if exit_enum.value != expected_enum.value:
+                raise Exception(
+                    f"Expected a '{expected_enum.value}' exit event but a "
+                    f"'{exit_enum.value}' exit event was encountered."
                 )
 
-            self._exit_event_count += 1
+        # Record the current tick and exit event enum.
+        self._tick_stopwatch.append((exit_enum, self.get_current_tick()))
+
+        try:
+            # If the user has specified their own generator for this exit
+            # event, use it.
+            exit_on_completion = next(self._on_exit_event[exit_enum])
+        except StopIteration:
+            # If the user's generator has ended, throw a warning and use
+            # the default generator for this exit event.
+            warn(
+                "User-specified generator for the exit event "
+                f"'{exit_enum.value}' has ended. Using the default "
+                "generator."
+            )
+            exit_on_completion = next(
+                self._default_on_exit_dict[exit_enum]
+            )
+        except KeyError:
+            # If the user has not specified their own generator for this
+            # exit event, use the default.
+            exit_on_completion = next(
+                self._default_on_exit_dict[exit_enum]
+            )
 
-            # If the generator returned True we will return from the Simulator
-            # run loop.
-            if exit_on_completion:
-                return
+        self._exit_event_count += 1
+
+        return exit_on_completion
 
     def save_checkpoint(self, checkpoint_dir: Path) -> None:
         """
@@ -0,0 +1,444 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Utilities for SimPoint-based sampling: reading the Basic Block Vectors
+(BBVs) written by the `SimPoint` probe, clustering them to select the
+representative intervals, reading and writing SimPoint files, and
+combining the statistics of the simulated regions.
+
+The clustering follows SimPoint 3.0 (Hamerly et al., JILP 2005): the BBVs
+are normalized, randomly projected to a few dimensions, and clustered with
+k-means for a range of k. The smallest k whose Bayesian Information
+Criterion (BIC) score reaches a fraction of the best score is selected, and
+the interval closest to the centroid of each cluster represents it.
+"""
+
+import gzip
+import math
+import random
+import re
+from typing import Dict, List, Optional, Sequence, Tuple
+
+
+def read_bbv(path: str) -> List[Dict[int, int]]:
+    """
+    Reads a BBV file written by the `SimPoint` probe (gzip compressed or
+    not).
+
+    :returns: One dictionary per interval, mapping basic block ids to the
+    number of instructions executed in the basic block.
+    """
+    opener = gzip.open if path.endswith(".gz") else open
+    bbvs = []
+    with opener(path, "rt") as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("T"):
+                continue
+            bbv = {}
+            for entry in line[1:].split():
+                _, bb, count = entry.split(":")
+                bbv[int(bb)] = int(count)
+            bbvs.append(bbv)
+    return bbvs
+
+
+def project_bbvs(
+    bbvs: Sequence[Dict[int, int]], dims: int = 15, seed: int = 42
+) -> List[List[float]]:
+    """
+    Normalizes the BBVs and projects them to `dims` dimensions with a random
+    matrix of values in [-1, 1]. The row of every basic block only depends
+    on its id and the seed, so the projection is reproducible.
+    """
+    rows = {}
+
+    def row(bb: int) -> List[float]:
+        if bb not in rows:
+            rng = random.Random(seed * 1000003 + bb)
+            rows[bb] = [rng.uniform(-1, 1) for _ in range(dims)]
+        return rows[bb]
+
+    points = []
+    for bbv in bbvs:
+        total = sum(bbv.values())
+        point = [0.0] * dims
+        if total:
+            for bb, count in bbv.items():
+                weight = count / total
+                for d, r in enumerate(row(bb)):
+                    point[d] += weight * r
+        points.append(point)
+    return points
+
+
+def _distance2(a: Sequence[float], b: Sequence[float]) -> float:
+    return sum((x - y) * (x - y) for x, y in zip(a, b))
+
+
+def kmeans(
+    points: Sequence[Sequence[float]],
+    k: int,
+    seed: int = 42,
+    max_iterations: int = 100,
+) -> Tuple[List[int], List[List[float]]]:
+    """
+    Clusters points with k-means, initialized with k-means++.
+
+    :returns: The cluster of every point and the centroids.
+    """
+    rng = random.Random(seed)
+    centroids = [list(points[rng.randrange(len(points))])]
+    while len(centroids) < k:
+        d2 = [min(_distance2(p, c) for c in centroids) for p in points]
+        total = sum(d2)
+        if total == 0:
+            break
+        target = rng.uniform(0, total)
+        acc = 0.0
+        for p, d in zip(points, d2):
+            acc += d
+            if acc >= target:
+                centroids.append(list(p))
+                break
+
+    assignment = [-1] * len(points)
+    for _ in range(max_iterations):
+        changed = False
+        for i, p in enumerate(points):
+            c = min(
+                range(len(centroids)),
+                key=lambda c: _distance2(p, centroids[c]),
+            )
+            if c != assignment[i]:
+                assignment[i] = c
+                changed = True
+        if not changed:
+            break
+
+        dims = len(points[0])
+        sums = [[0.0] * dims for _ in centroids]
+        counts = [0] * len(centroids)
+        for p, c in zip(points, assignment):
+            counts[c] += 1
+            for d in range(dims):
+                sums[c][d] += p[d]
+        for c in range(len(centroids)):
+            if counts[c]:
+                centroids[c] = [s / counts[c] for s in sums[c]]
+
+    return assignment, centroids
+
+
+def bic_score(
+    points: Sequence[Sequence[float]],
+    assignment: Sequence[int],
+    centroids: Sequence[Sequence[float]],
+) -> float:
+    """
+    Bayesian Information Criterion of a clustering, modeling the clusters
+    as spherical Gaussians (Pelleg and Moore, ICML 2000).
+    """
+    r = len(points)
+    k = len(centroids)
+    m = len(points[0])
+
+    distortion = sum(
+        _distance2(p, centroids[c]) for p, c in zip(points, assignment)
+    )
+    variance = distortion / (m * (r - k)) if r > k else 0.0
+    # Avoid the singularity of a perfect clustering
+    variance = max(variance, 1e-12)
+
+    likelihood = 0.0
+    for c in range(k):
+        rc = assignment.count(c)
+        if rc == 0:
+            continue
+        likelihood += (
+            rc * math.log(rc)
+            - rc * math.log(r)
+            - rc * m / 2 * math.log(2 * math.pi * variance)
+            - m * (rc - 1) / 2
+        )
+
+    parameters = (k - 1) + m * k + 1
+    return likelihood - parameters / 2 * math.log(r)
+
+
+def select_simpoints(
+    bbvs: Sequence[Dict[int, int]],
+    max_k: int = 30,
+    dims: int = 15,
+    bic_threshold: float = 0.9,
+    seed: int = 42,
+) -> List[Tuple[int, float]]:
+    """
+    Selects the representative intervals of a workload.
+
+    :param bbvs: The BBV of every interval, as returned by `read_bbv()`.
+    :param max_k: The maximum number of clusters.
+    :param dims: The number of dimensions of the random projection.
+    :param bic_threshold: The smallest k whose BIC score reaches this
+    fraction of the range of scores is selected.
+    :param seed: The seed of the projection and of the clustering.
+
+    :returns: A list of (interval index, weight) pairs, sorted by interval.
+    The weights sum to 1.
+    """
+    if not bbvs:
+        return []
+
+    points = project_bbvs(bbvs, dims=dims, seed=seed)
+    max_k = min(max_k, len(points))
+
+    clusterings = []
+    for k in range(1, max_k + 1):
+        assignment, centroids = kmeans(points, k, seed=seed + k)
+        score = bic_score(points, assignment, centroids)
+        clusterings.append((score, assignment, centroids))
+
+    scores = [c[0] for c in clusterings]
+    low, high = min(scores), max(scores)
+    for score, assignment, centroids in clusterings:
+        if score >= low + bic_threshold * (high - low):
+            break
+
+    simpoints = []
+    for c, centroid in enumerate(centroids):
+        members = [i for i, a in enumerate(assignment) if a == c]
+        if not members:
+            continue
+        closest = min(members, key=lambda i: _distance2(points[i], centroid))
+        simpoints.append((closest, len(members) / len(points)))
+    return sorted(simpoints)
+
+
+def write_simpoints(
+    simpoints: Sequence[Tuple[int, float]],
+    simpoints_path: str,
+    weights_path: str,
+) -> None:
+    """
+    Writes SimPoints in the format of the SimPoint tool: one
+    "<interval> <id>" line per SimPoint and one "<weight> <id>" line per
+    weight.
+    """
+    with open(simpoints_path, "w") as f:
+        for i, (interval, _) in enumerate(simpoints):
+            f.write(f"{interval} {i}\n")
+    with open(weights_path, "w") as f:
+        for i, (_, weight) in enumerate(simpoints):
+            f.write(f"{weight} {i}\n")
+
+
+def read_simpoints(
+    simpoints_path: str, weights_path: str
+) -> List[Tuple[int, float]]:
+    """
+    Reads SimPoints in the format of the SimPoint tool.
+
+    :returns: A list of (interval index, weight) pairs, sorted by interval.
+    """
+    intervals = {}
+    with open(simpoints_path) as f:
+        for line in f:
+            if line.strip():
+                interval, sid = line.split()
+                intervals[int(sid)] = int(interval)
+    weights = {}
+    with open(weights_path) as f:
+        for line in f:
+            if line.strip():
+                weight, sid = line.split()
+                weights[int(sid)] = float(weight)
+    return sorted((intervals[s], weights[s]) for s in intervals)
+
+
+_begin_marker = "---------- Begin Simulation Statistics ----------"
+_end_marker = "---------- End Simulation Statistics   ----------"
+_number = re.compile(r"^(-?[0-9]+(?:\.[0-9]*)?|nan|-?inf)(%?)$")
+_rate_unit = re.compile(r"\(+([A-Za-z]+)/([A-Za-z]+)\)+\s*$")
+
+
+def read_stats(path: str, dump: int = 0) -> List[Tuple[str, List[str], str]]:
+    """
+    Reads one dump of a stats.txt file.
+
+    :param dump: The index of the dump to read.
+
+    :returns: A list of (name, values, description) tuples, in the order of
+    the file. The values are kept as strings.
+    """
+    stats = []
+    current = -1
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith(_begin_marker):
+                current += 1
+                continue
+            if line.startswith(_end_marker):
+                if current == dump:
+                    break
+                continue
+            if current != dump or not line.strip():
+                continue
+            values, _, desc = line.partition(" # ")
+            tokens = values.split()
+            stats.append((tokens[0], tokens[1:], desc))
+    return stats
+
+
+def _weighted_value(tokens: Sequence[Optional[str]], weights) -> str:
+    """Weighted sum of numeric tokens, None standing for a missing stat."""
+    present = [t for t in tokens if t is not None]
+    matches = [_number.match(t) for t in present]
+    if not all(matches):
+        return present[0]
+
+    total = 0.0
+    decimals = 0
+    for token, weight in zip(tokens, weights):
+        if token is None:
+            continue
+        m = _number.match(token)
+        total += weight * float(m.group(1))
+        if "." in m.group(1):
+            decimals = max(decimals, len(m.group(1).split(".")[1]))
+
+    if math.isnan(total):
+        value = "nan"
+    elif math.isinf(total):
+        value = "inf" if total > 0 else "-inf"
+    else:
+        if decimals == 0 and total != round(total):
+            decimals = 6
+        value = f"{total:.{decimals}f}"
+    return value + matches[0].group(2)
+
+
+def _rate_denominator(
+    name: str, desc: str, stats: Dict[str, List[str]]
+) -> Optional[float]:
+    """
+    Returns the value of the denominator of a rate stat in a region (e.g.,
+    the cycles of the CPU of its IPC), or None if the stat is not a rate
+    or its denominator is unknown.
+    """
+    unit = _rate_unit.search(desc)
+    if not unit:
+        return None
+
+    denominator = unit.group(2)
+    if denominator == "Cycle":
+        prefix = name
+        candidates = []
+        while "." in prefix:
+            prefix = prefix.rsplit(".", 1)[0]
+            candidates.append(f"{prefix}.numCycles")
+    elif denominator == "Second":
+        candidates = ["simSeconds"]
+    elif denominator == "Tick":
+        candidates = ["simTicks"]
+    else:
+        return None
+
+    for candidate in candidates:
+        if candidate in stats:
+            m = _number.match(stats[candidate][0])
+            return float(m.group(1)) if m else None
+    return None
+
+
+def reweight_stats(
+    regions: Sequence[Tuple[str, float]], output_path: str
+) -> None:
+    """
+    Combines the statistics of simulated regions into a single stats.txt
+    file, each value being the weighted average of the values of the
+    regions. The output has the same layout as a stats.txt file, so the
+    tools parsing those work unchanged.
+
+    Counts are the weighted counts of a region. Rates per cycle, second or
+    tick (e.g., IPC) are recomputed from the weighted counts, i.e., the
+    rates of the regions are averaged with the weight of a region
+    multiplied by its cycles, seconds or ticks. Other ratios (e.g., CPI or
+    misses per kilo instructions) are averaged with the region weights,
+    which gives the same result as all regions have the same number of
+    instructions.
+
+    :param regions: A list of (stats.txt path, weight) pairs. The weights
+    are normalized.
+    """
+    total_weight = sum(weight for _, weight in regions)
+    weights = [weight / total_weight for _, weight in regions]
+    region_stats = [read_stats(path) for path, _ in regions]
+
+    # Keep the order of the first region, adding the stats that only
+    # appear in the others at the end.
+    order = []
+    descs = {}
+    values = [{} for _ in regions]
+    for r, stats in enumerate(region_stats):
+        for name, vals, desc in stats:
+            if name not in descs:
+                order.append(name)
+                descs[name] = desc
+            values[r][name] = vals
+
+    def stat_weights(name: str) -> List[float]:
+        denominators = [
+            _rate_denominator(name, descs[name], v) if name in v else 0.0
+            for v in values
+        ]
+        if any(d is None for d in denominators):
+            return weights
+        scaled = [w * d for w, d in zip(weights, denominators)]
+        total = sum(scaled)
+        if total <= 0:
+            return weights
+        return [w / total for w in scaled]
+
+    with open(output_path, "w") as f:
+        f.write(f"\n{_begin_marker}\n")
+        for name in order:
+            width = max(len(v.get(name, [])) for v in values)
+            rate_weights = stat_weights(name)
+            columns = []
+            for col in range(width):
+                tokens = [
+                    v[name][col] if name in v and col < len(v[name]) else None
+                    for v in values
+                ]
+                columns.append(_weighted_value(tokens, rate_weights))
+
+            line = f"{name:<40} " + " ".join(f"{c:>12}" for c in columns)
+            if descs[name]:
+                line += f" # {descs[name]}"
+            f.write(line + "\n")
+        f.write(f"\n{_end_marker}\n")
@@ -1014,12 +1014,17 @@ class SimObject(object, metaclass=MetaSimObject):
     def unproxy(self, base):
         return self
 
-    def unproxyParams(self):
+    # If a startup.ProxyCache is given, the proxies are resolved through
+    # it, which may reuse the results of a previous run.
+    def unproxyParams(self, cache=None):
         for param in self._params.keys():
             value = self._values.get(param)
             if value != None and isproxy(value):
                 try:
-                    value = value.unproxy(self)
+                    if cache is not None:
+                        value = cache.unproxy(self, param, value)
+                    else:
+                        value = value.unproxy(self)
                 except:
                     print("Error in unproxying param '%s' of %s" %
                           (param, self.path()))
@@ -1033,7 +1038,7 @@ class SimObject(object, metaclass=MetaSimObject):
         for port_name in port_names:
             port = self._port_refs.get(port_name)
             if port != None:
-                port.unproxy(self)
+                port.unproxy(self, cache)
 
     def print_ini(self, ini_file):
         print('[' + self.path() + ']', file=ini_file)    # .ini section header
@@ -1195,6 +1200,37 @@ class SimObject(object, metaclass=MetaSimObject):
         for (attr, portRef) in sorted(self._port_refs.items()):
             portRef.ccConnect()
 
+    # Minimum latency, in ticks, between a message arriving on one of
+    # the ports of this object and the first event the object schedules
+    # in response. It bounds the lookahead of the event queue of this
+    # object with respect to the queues of its peers. Objects that may
+    # react within the same tick must return 0.
+    def minPortLatency(self):
+        return 0
+
+    # Connections between two other SimObjects that this object models
+    # without gem5 ports (e.g., network links), as a list of
+    # (obj_a, obj_b, latency in ticks) tuples. They are used along with
+    # the port connections to compute the lookahead between event queues.
+    def lookaheadLinks(self):
+        return []
+
+    # Estimated number of events this object processes per tick, used to
+    # balance the automatic partitioning of the system into event queues.
+    def eventRateEstimate(self):
+        return 0.0
+
+    # Containers (e.g., systems) are not assigned to an event queue as a
+    # whole when partitioning the system, each of their children is.
+    def isEventQueueContainer(self):
+        return False
+
+    # Objects that are safe to access from any event queue (e.g., clock
+    # domains) do not force the objects that refer to them to share their
+    # event queue.
+    def isEventQueueShared(self):
+        return False
+
     # Default function for generating the device structure.
     # Can be overloaded by the inheriting class
     def generateDeviceTree(self, state):
@@ -112,6 +112,12 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-filter", metavar="PATTERN[,PATTERN]", action="append",
+        split=",", help="Only output the statistics whose full name "
+        "matches one of the wildcard patterns")
+    option("--stats-dump-threads", metavar="N", type="int", default=1,
+        help="Number of threads used to dump the statistics "
+        "[Default: %default]")
     option("--stats-help",
            action="callback", callback=_stats_help,
            help="Display documentation for available stat visitors")
@@ -127,6 +133,12 @@ def parse_options():
     option("--dot-dvfs-config", metavar="FILE", default=None,
         help="Create DOT & pdf outputs of the DVFS configuration" + \
              " [Default: %default]")
+    option("--startup-profile", action="store_true", default=False,
+        help="Print the time spent in each phase of the startup when the "
+        "simulation starts")
+    option("--startup-cache", metavar="DIR", default=None,
+        help="Cache the resolved proxies of the configuration in DIR and "
+        "reuse them when the same configuration is instantiated again")
 
     # Debugging options
     group("Debugging Options")
@@ -202,6 +214,7 @@ def main():
     from . import defines
     from . import event
     from . import info
+    from . import startup
     from . import stats
     from . import trace
 
@@ -342,6 +355,12 @@ def main():
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    for pattern in options.stats_filter:
+        stats.addStatFilter(pattern)
+    stats.setDumpThreads(options.stats_dump_threads)
+
+    if options.startup_profile:
+        startup.enableReport()
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -431,7 +450,11 @@ def main():
                 t = t.tb_next
                 pdb.interaction(t.tb_frame,t)
     else:
-        exec(filecode, scope)
+        with startup.phase("config script"):
+            exec(filecode, scope)
+
+    # Report the startup of scripts which didn't simulate
+    startup.report()
 
     # once the script is done
     if options.interactive:
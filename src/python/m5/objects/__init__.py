@@ -24,6 +24,9 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-for module in __spec__.loader_state:
-    if module.startswith('m5.objects.'):
-        exec("from %s import *" % module)
+import m5.startup as _startup
+
+with _startup.phase("import m5.objects"):
+    for module in __spec__.loader_state:
+        if module.startswith('m5.objects.'):
+            exec("from %s import *" % module)
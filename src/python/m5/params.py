@@ -1875,11 +1875,15 @@ class PortRef(object):
             assert(not isinstance(newRef.peer, VectorPortRef))
         return newRef
 
-    def unproxy(self, simobj):
+    def unproxy(self, simobj, cache=None):
         assert(simobj is self.simobj)
         if proxy.isproxy(self.peer):
             try:
-                realPeer = self.peer.unproxy(self.simobj)
+                if cache is not None:
+                    realPeer = cache.unproxy(self.simobj,
+                            '%s[%d]' % (self.name, self.index), self.peer)
+                else:
+                    realPeer = self.peer.unproxy(self.simobj)
             except:
                 print("Error in unproxying port '%s' of %s" %
                       (self.name, self.simobj.path()))
@@ -1980,8 +1984,8 @@ class VectorPortRef(object):
         newRef.elements = [el.clone(simobj, memo) for el in self.elements]
         return newRef
 
-    def unproxy(self, simobj):
-        [el.unproxy(simobj) for el in self.elements]
+    def unproxy(self, simobj, cache=None):
+        [el.unproxy(simobj, cache) for el in self.elements]
 
     def ccConnect(self):
         [el.ccConnect() for el in self.elements]
@@ -48,13 +48,17 @@ from _m5.stats import updateEvents as updateStatEvents
 
 from . import stats
 from . import SimObject
+from . import startup
 from . import ticks
 from . import objects
 from . import params
 from m5.util.dot_writer import do_dot, do_dvfs_dot
 from m5.util.dot_writer_ruby import do_ruby_dot
+from m5.util.eventq_graph import lookahead_matrix, \
+    merge_zero_latency_queues
+from m5.util.eventq_partition import partition, write_report
 
-from .util import fatal
+from .util import fatal, warn
 from .util import attrdict
 
 # define a MaxTick parameter, unsigned 64 bit
@@ -66,6 +70,7 @@ _instantiated = False # Has m5.instantiate() been called?
 
 # The final call to instantiate the SimObject graph and initialize the
 # system.
+@startup.timed("instantiate")
 def instantiate(ckpt_dir=None):
     global _instantiated
     from m5 import options
@@ -85,10 +90,37 @@ def instantiate(ckpt_dir=None):
 
     # Make sure SimObject-valued params are in the configuration
     # hierarchy so we catch them with future descendants() walks
-    for obj in root.descendants(): obj.adoptOrphanParams()
+    with startup.phase("adopt orphan params"):
+        for obj in root.descendants(): obj.adoptOrphanParams()
 
     # Unproxy in sorted order for determinism
-    for obj in root.descendants(): obj.unproxyParams()
+    with startup.phase("resolve proxies"):
+        if options.startup_cache:
+            cache = startup.ProxyCache(root, options.startup_cache)
+            for obj in root.descendants(): obj.unproxyParams(cache)
+            cache.save()
+        else:
+            for obj in root.descendants(): obj.unproxyParams()
+
+    # Assign the objects to event queues, and make sure the queues
+    # synchronize often enough for the connections that were cut
+    num_queues = int(root.eventq_partitions)
+    if num_queues > 1:
+        cuts = partition(root, num_queues)
+        min_cut = write_report(root, num_queues, cuts, options.outdir,
+                               'eventq_partition.txt')
+        if str(root.eventq_sync) == 'quantum' and \
+           int(root.sim_quantum) == 0 and min_cut != MaxTick:
+            root.sim_quantum = min_cut
+
+    # Derive the lookahead between event queues from the latencies of
+    # the links that cross them
+    if str(root.eventq_sync) == 'conservative' and \
+       len(root.eventq_lookahead) == 0:
+        for a, b in merge_zero_latency_queues(root):
+            warn("%s and %s are connected with no latency, their event "
+                 "queues have been merged." % (a, b))
+        root.eventq_lookahead = lookahead_matrix(root)
 
     if options.dump_config:
         ini_file = open(os.path.join(options.outdir, options.dump_config), 'w')
@@ -116,15 +148,19 @@ def instantiate(ckpt_dir=None):
     stats.initSimStats()
 
     # Create the C++ sim objects and connect ports
-    for obj in root.descendants(): obj.createCCObject()
-    for obj in root.descendants(): obj.connectPorts()
+    with startup.phase("create C++ objects"):
+        for obj in root.descendants(): obj.createCCObject()
+    with startup.phase("connect ports"):
+        for obj in root.descendants(): obj.connectPorts()
 
     # Do a second pass to finish initializing the sim objects
-    for obj in root.descendants(): obj.init()
+    with startup.phase("init"):
+        for obj in root.descendants(): obj.init()
 
     # Do a third pass to initialize statistics
-    stats._bindStatHierarchy(root)
-    root.regStats()
+    with startup.phase("register stats"):
+        stats._bindStatHierarchy(root)
+        root.regStats()
 
     # Do a fourth pass to initialize probe points
     for obj in root.descendants(): obj.regProbePoints()
@@ -143,11 +179,13 @@ def instantiate(ckpt_dir=None):
 
     # Restore checkpoint (if any)
     if ckpt_dir:
-        _drain_manager.preCheckpointRestore()
-        ckpt = _m5.core.getCheckpoint(ckpt_dir)
-        for obj in root.descendants(): obj.loadState(ckpt)
+        with startup.phase("restore checkpoint"):
+            _drain_manager.preCheckpointRestore()
+            ckpt = _m5.core.getCheckpoint(ckpt_dir)
+            for obj in root.descendants(): obj.loadState(ckpt)
     else:
-        for obj in root.descendants(): obj.initState()
+        with startup.phase("initState"):
+            for obj in root.descendants(): obj.initState()
 
     # Check to see if any of the stat events are in the past after resuming from
     # a checkpoint, If so, this call will shift them to be at a valid time.
@@ -163,8 +201,10 @@ def simulate(*args, **kwargs):
 
     if need_startup:
         root = objects.Root.getInstance()
-        for obj in root.descendants(): obj.startup()
+        with startup.phase("startup"):
+            for obj in root.descendants(): obj.startup()
         need_startup = False
+        startup.report()
 
         # Python exit handlers happen in reverse order.
         # We want to dump stats last.
@@ -232,7 +272,14 @@ def memInvalidate(root):
     for obj in root.descendants():
         obj.memInvalidate()
 
-def checkpoint(dir):
+def checkpoint(dir, index=False):
+    '''Write a checkpoint of the simulation to a directory.
+
+    If index is True, a binary index of the checkpoint is also written
+    to make restoring it faster. The index of an existing checkpoint can
+    be written with _m5.core.writeCheckpointIndex(dir).
+    '''
+
     root = objects.Root.getInstance()
     if not isinstance(root, objects.Root):
         raise TypeError("Checkpoint must be called on a root object.")
@@ -241,6 +288,8 @@ def checkpoint(dir):
     memWriteback(root)
     print("Writing checkpoint")
     _m5.core.serializeAll(dir)
+    if index and not _m5.core.writeCheckpointIndex():
+        warn("Unable to write the index of the checkpoint.")
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
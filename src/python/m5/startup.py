@@ -0,0 +1,253 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Profiling and caching of the gem5 startup.
+
+The startup of gem5 (importing the SimObjects, running the config
+script and instantiating the C++ objects) is split into phases which
+are always timed, as timing them is cheap. The timings are reported
+when the simulation starts if --startup-profile is given.
+
+The results of the proxy resolution of a configuration can be cached
+on disk, in the directory given by --startup-cache, keyed by a hash of
+the configuration, so that later instantiations of the same
+configuration don't resolve the proxies again.
+"""
+
+import contextlib
+import functools
+import hashlib
+import os
+import pickle
+import sys
+import time
+
+# Phases which are over, as (depth, name, start, duration) tuples.
+_phases = []
+# Phases which are still running, as (name, start) tuples.
+_running = []
+
+def _now():
+    return time.perf_counter()
+
+@contextlib.contextmanager
+def phase(name):
+    """Time a phase of the startup, phases may be nested."""
+
+    depth = len(_running)
+    start = _now()
+    _running.append((name, start))
+    try:
+        yield
+    finally:
+        _running.pop()
+        _phases.append((depth, name, start, _now() - start))
+
+def timed(name):
+    """Decorator timing every call of a function as a startup phase."""
+
+    def decorator(func):
+        @functools.wraps(func)
+        def wrapper(*args, **kwargs):
+            with phase(name):
+                return func(*args, **kwargs)
+        return wrapper
+    return decorator
+
+_enabled = False
+_reported = False
+
+def enableReport():
+    """Report the startup phases when the simulation starts."""
+
+    global _enabled
+    _enabled = True
+
+def report(file=sys.stdout):
+    """Print the time spent in each phase so far, once. Phases which are
+    still running (e.g. the config script) are reported up to now."""
+
+    global _reported
+    if not _enabled or _reported:
+        return
+    _reported = True
+
+    now = _now()
+    records = list(_phases)
+    records.extend((depth, name + " (running)", start, now - start)
+                   for depth, (name, start) in enumerate(_running))
+    records.sort(key=lambda r: (r[2], r[0]))
+
+    print("Startup profile (seconds):", file=file)
+    for depth, name, start, duration in records:
+        print("  %9.3f  %s%s" % (duration, "  " * depth, name), file=file)
+
+class ProxyCache(object):
+    """Resolved proxies of a configuration.
+
+    The resolved value of each proxy parameter and port is recorded by
+    the path of its object, and stored in a file named after the hash
+    of the configuration. Only the values which are SimObjects or ports
+    in the configuration are recorded, other proxies are resolved as
+    usual.
+    """
+
+    def __init__(self, root, cache_dir):
+        self.path = os.path.join(cache_dir,
+                                 "proxies-%s.pickle" % configHash(root))
+        self.resolved = {}
+        self.recorded = {}
+        self.hits = 0
+        try:
+            with open(self.path, "rb") as f:
+                self.resolved = pickle.load(f)
+        except (OSError, EOFError, pickle.UnpicklingError):
+            pass
+
+        self.objects = { obj.path() : obj for obj in root.descendants() }
+
+    def unproxy(self, obj, key, value):
+        """Resolve the proxy value of the parameter or port key of obj."""
+
+        path = (obj.path(), key)
+        entry = self.resolved.get(path)
+        if entry is not None:
+            resolved = self._decode(entry)
+            if resolved is not None:
+                self.hits += 1
+                self.recorded[path] = entry
+                return resolved
+
+        resolved = value.unproxy(obj)
+        entry = self._encode(resolved)
+        if entry is not None:
+            self.recorded[path] = entry
+        return resolved
+
+    def save(self):
+        """Write the cache if anything new was resolved."""
+
+        if self.recorded == self.resolved:
+            return
+
+        os.makedirs(os.path.dirname(self.path) or ".", exist_ok=True)
+        tmp = "%s.%d" % (self.path, os.getpid())
+        with open(tmp, "wb") as f:
+            pickle.dump(self.recorded, f, pickle.HIGHEST_PROTOCOL)
+        os.replace(tmp, self.path)
+
+    def _encode(self, value):
+        from m5.SimObject import isSimObject, isNullPointer
+        from m5.params import PortRef, VectorPortRef
+
+        def path_of(obj):
+            path = obj.path()
+            return path if self.objects.get(path) is obj else None
+
+        if isNullPointer(value):
+            return ("null",)
+        elif isSimObject(value):
+            path = path_of(value)
+            return ("obj", path) if path else None
+        elif isinstance(value, (list, tuple)):
+            if not all(isSimObject(v) for v in value):
+                return None
+            paths = [ path_of(v) for v in value ]
+            return ("objs", paths) if all(paths) else None
+        elif isinstance(value, (PortRef, VectorPortRef)):
+            path = path_of(value.simobj)
+            if not path:
+                return None
+            index = value.index if isinstance(value, PortRef) else None
+            return ("port", path, value.name, index)
+        return None
+
+    def _decode(self, entry):
+        from m5.SimObject import NULL
+
+        kind = entry[0]
+        if kind == "null":
+            return NULL
+        elif kind == "obj":
+            return self.objects.get(entry[1])
+        elif kind == "objs":
+            objs = [ self.objects.get(p) for p in entry[1] ]
+            return objs if all(o is not None for o in objs) else None
+        elif kind == "port":
+            kind, path, name, index = entry
+            obj = self.objects.get(path)
+            if obj is None:
+                return None
+            port = getattr(obj, name)
+            return port if index is None or index < 0 else port[index]
+        return None
+
+def _valueKey(value):
+    """A string identifying a (possibly unresolved) parameter value."""
+
+    from m5.SimObject import isSimObject
+    from m5.params import PortRef, VectorPortRef
+    from m5.proxy import isproxy
+
+    if isproxy(value):
+        return "proxy:%s" % value
+    elif isinstance(value, (PortRef, VectorPortRef)):
+        return "port:%s" % value
+    elif isSimObject(value):
+        return "obj:%s" % value.path()
+    elif isinstance(value, (list, tuple)):
+        return "[%s]" % ",".join(_valueKey(v) for v in value)
+    try:
+        return value.ini_str()
+    except Exception:
+        return str(value)
+
+def configHash(root):
+    """Hash of the unresolved configuration under root.
+
+    It covers the objects, their classes (which decide what the proxies
+    match), their parameter values and their port connections.
+    """
+
+    h = hashlib.sha1()
+    classes = set()
+    for obj in root.descendants():
+        cls = type(obj)
+        if cls not in classes:
+            classes.add(cls)
+            h.update(("class %s(%s)\n" % (cls.__name__, ",".join(
+                c.__name__ for c in cls.__mro__))).encode())
+        h.update(("[%s] %s\n" % (obj.path(), cls.__name__)).encode())
+        for param in sorted(obj._params.keys()):
+            value = obj._values.get(param)
+            if value is not None:
+                h.update(("%s=%s\n" % (param, _valueKey(value))).encode())
+        for port_name in sorted(obj._port_refs.keys()):
+            port = obj._port_refs[port_name]
+            refs = getattr(port, "elements", [port])
+            h.update(("%s->%s\n" % (port_name, ",".join(
+                _valueKey(ref.peer) for ref in refs))).encode())
+    return h.hexdigest()
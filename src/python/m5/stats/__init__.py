@@ -183,6 +183,28 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "columnar", ])
+def _columnarFactory(fn):
+    """Output stats in a binary columnar format.
+
+    The stat names, descriptions and units are written once, and every
+    dump then appends a row with the raw values of all the stats. This is
+    much faster and smaller than the text format for frequent periodic
+    dumps, and needs no external library.
+
+    The files can be loaded into numpy arrays with
+    util/columnar_stats.py.
+
+    Known limitations:
+      * Sparse histograms are unsupported.
+
+    Example:
+      columnar://stats.cst
+
+    """
+
+    return _m5.stats.initColumnar(fn)
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
@@ -324,10 +346,93 @@ def enable():
 
     _m5.stats.enable();
 
+# Compiled patterns of the stats to dump, all of them if empty.
+_stat_filters = []
+# Literal prefix of each pattern, used to skip whole groups, or None
+# for regular expressions, which may match anything.
+_stat_filter_prefixes = []
+# Selected stats of the dump roots, by path of the root.
+_selections = {}
+
+def addStatFilter(pattern, regex=False):
+    '''Only dump the stats whose full name matches a pattern.
+
+    Patterns are shell-style wildcards (e.g., "system.cpu*.ipc" or
+    "*.dcache.demandMisses"), or regular expressions if regex is True,
+    and have to match the whole name of a stat. The stats matching any
+    of the filters are dumped, and all the stats are if there is no
+    filter.
+
+    The stats that are not selected are not prepared, their formulas are
+    not evaluated, and groups that can't contain a selected stat are not
+    visited at all, so dumping a few stats of a large system is cheap.
+    The selection is computed once, at the first dump.
+
+    Filters apply to all the stat visitors except the JSON one.
+    '''
+
+    import fnmatch
+    import re
+
+    if regex:
+        _stat_filters.append(re.compile(pattern))
+        _stat_filter_prefixes.append(None)
+    else:
+        _stat_filters.append(re.compile(fnmatch.translate(pattern)))
+        _stat_filter_prefixes.append(re.split(r"[*?\[]", pattern)[0])
+    _selections.clear()
+
+def _is_selected(name):
+    return any(f.fullmatch(name) for f in _stat_filters)
+
+def _may_contain_selected(path):
+    prefix = path + "."
+    return any(p is None or p.startswith(prefix) or prefix.startswith(p)
+               for p in _stat_filter_prefixes)
+
+def _select(group, path):
+    '''Selected stats and groups under a group, as a (stats, [(name,
+    selection)]) tuple, or None if nothing is selected.'''
+
+    name = ".".join(path)
+    if path and not _may_contain_selected(name):
+        return None
+
+    prefix = name + "." if path else ""
+    stats = [ s for s in group.getStats() if _is_selected(prefix + s.name) ]
+    groups = []
+    for n, g in group.getStatGroups().items():
+        selection = _select(g, path + [ n ])
+        if selection:
+            groups.append((n, selection))
+    return (stats, groups) if stats or groups else None
+
+def _selection(root, path):
+    key = ".".join(path)
+    if key not in _selections:
+        _selections[key] = _select(root, path)
+    return _selections[key]
+
+def _visit_selection(visitor, selection):
+    if selection:
+        stats, groups = selection
+        for stat in stats:
+            visitor(stat)
+        for n, g in groups:
+            _visit_selection(visitor, g)
+
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
+    if _stat_filters:
+        _visit_selection(lambda s: s.prepare(),
+                         _selection(Root.getInstance(), []))
+        for stat in stats_list:
+            if _is_selected(stat.name):
+                stat.prepare()
+        return
+
     # Legacy stats
     for stat in stats_list:
         stat.prepare()
@@ -335,31 +440,57 @@ def prepare():
     # New stats
     _visit_stats(lambda g, s: s.prepare())
 
+# Number of threads used to visit the stats of the hierarchy.
+_dump_threads = 1
+
+def setDumpThreads(threads):
+    '''Set the number of threads used to dump the stats.
+
+    The stat groups are split into chunks that are evaluated and
+    formatted concurrently, and the outputs of the chunks are merged in
+    order, so the output is the same as with a single thread. Only the
+    text output supports this, other outputs are always dumped by a
+    single thread.
+    '''
+
+    global _dump_threads
+    _dump_threads = max(1, int(threads))
+
 def _dump_to_visitor(visitor, roots=None):
     # New stats
-    def dump_group(group):
-        for stat in group.getStats():
+    def dump_selection(selection):
+        if not selection:
+            return
+        stats, groups = selection
+        for stat in stats:
             stat.visit(visitor)
-        for n, g in group.getStatGroups().items():
+        for n, g in groups:
             visitor.beginGroup(n)
-            dump_group(g)
+            dump_selection(g)
             visitor.endGroup()
 
+    def dump_root(root, path):
+        if _stat_filters:
+            dump_selection(_selection(root, path))
+        else:
+            _m5.stats.visitGroup(root.getCCObject(), visitor, _dump_threads)
+
     if roots:
         # New stats from selected subroots.
         for root in roots:
             for p in root.path_list():
                 visitor.beginGroup(p)
-            dump_group(root)
+            dump_root(root, root.path_list())
             for p in reversed(root.path_list()):
                 visitor.endGroup()
     else:
         # New stats starting from root.
-        dump_group(Root.getInstance())
+        dump_root(Root.getInstance(), [])
 
         # Legacy stats
         for stat in stats_list:
-            stat.visit(visitor)
+            if not _stat_filters or _is_selected(stat.name):
+                stat.visit(visitor)
 
 lastDump = 0
 # List[SimObject].
@@ -420,6 +551,42 @@ def reset():
 
     _m5.stats.processResetQueue()
 
+# List of ColumnarSnapshot, and whether their layout has been recorded.
+_snapshots = []
+
+def enableSnapshots(fn="stats_snapshots.cst", capacity=4096):
+    """Record cheap snapshots of all the stats in a columnar stats file.
+
+    Every call to snapshot() copies the raw counters of the stats into a
+    buffer of capacity rows, which is written to fn in the output
+    directory when it is full and when gem5 exits. Unlike dump(), a
+    snapshot doesn't evaluate formulas nor format anything, and the
+    stats are not meant to be reset between snapshots: the values of an
+    interval are the difference between two consecutive snapshots, see
+    ColumnarStats.deltas() in util/columnar_stats.py.
+    """
+
+    import atexit
+
+    snap = _m5.stats.initColumnarSnapshot(fn, capacity)
+    _snapshots.append([snap, False])
+    atexit.register(snap.flush)
+    return snap
+
+def snapshot():
+    """Take a snapshot of the stats for every enabled snapshot file"""
+
+    for entry in _snapshots:
+        snap, laid_out = entry
+        if not laid_out:
+            # Record which stats to copy once, after they are created
+            prepare()
+            snap.begin()
+            _dump_to_visitor(snap)
+            snap.end()
+            entry[1] = True
+        snap.take()
+
 flags = attrdict({
     'none'    : 0x0000,
     'init'    : 0x0001,
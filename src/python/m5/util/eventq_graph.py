@@ -0,0 +1,112 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Builds the communication graph of a SimObject hierarchy, as used to
+# synchronize and partition multiple main event queues. The vertices are
+# the SimObjects and the edges are the port connections and the links
+# reported by SimObject.lookaheadLinks(), weighted by the minimum latency
+# of a message crossing them.
+
+# unsigned 64 bit, as in m5.simulate
+MaxTick = 2**64 - 1
+
+def _port_peers(obj):
+    for ref in obj._port_refs.values():
+        for port in getattr(ref, 'elements', [ref]):
+            if port.peer is not None:
+                yield port.peer.simobj
+
+def link_graph(root):
+    """Return the edges of the graph of root as a dictionary mapping
+    (a, b) pairs of SimObjects to the minimum latency in ticks of a
+    message from a to b. A message crossing a port connection is handled
+    by its receiver, on the thread of the sender, and the receiver
+    schedules the resulting events on its own queue, so the latency from
+    a to b is the one of b. The two directions usually differ, e.g. a
+    crossbar delays the requests of a CPU but the CPU may react to a
+    response within the same tick.
+    """
+    edges = {}
+    objs = {}
+
+    def add(a, b, latency):
+        objs[id(a)] = a
+        objs[id(b)] = b
+        key = (id(a), id(b))
+        edges[key] = min(edges.get(key, MaxTick), int(latency))
+
+    for obj in root.descendants():
+        for peer in _port_peers(obj):
+            add(obj, peer, peer.minPortLatency())
+            add(peer, obj, obj.minPortLatency())
+        for src, dst, latency in obj.lookaheadLinks():
+            add(src, dst, latency)
+            add(dst, src, latency)
+
+    return dict(((objs[a], objs[b]), lat)
+                for (a, b), lat in edges.items() if a != b)
+
+def num_queues(root):
+    return max([ int(obj.eventq_index) for obj in root.descendants() ] +
+               [ 0 ]) + 1
+
+def merge_zero_latency_queues(root):
+    """A connection with no latency can't be cut between event queues,
+    as nothing bounds how early the messages crossing it arrive. Move
+    the objects of the queues joined by such connections to the lowest
+    of these queues, and renumber the queues to keep them contiguous.
+    Return the list of (a, b) objects whose connection caused a merge.
+    """
+    parent = list(range(num_queues(root)))
+    def find(i):
+        while parent[i] != i:
+            parent[i] = parent[parent[i]]
+            i = parent[i]
+        return i
+
+    merged = []
+    for (a, b), latency in link_graph(root).items():
+        i, j = find(int(a.eventq_index)), find(int(b.eventq_index))
+        if latency == 0 and i != j:
+            parent[max(i, j)] = min(i, j)
+            merged.append((a, b))
+
+    if merged:
+        used = sorted(set(find(int(obj.eventq_index))
+                          for obj in root.descendants()))
+        index = dict((q, i) for i, q in enumerate(used))
+        for obj in root.descendants():
+            obj.eventq_index = index[find(int(obj.eventq_index))]
+    return merged
+
+def lookahead_matrix(root):
+    """Return the flattened, source major, matrix of the minimum latency
+    between every pair of event queues, MaxTick if no edge crosses them.
+    """
+    n = num_queues(root)
+    matrix = [ MaxTick ] * (n * n)
+    for (a, b), latency in link_graph(root).items():
+        i, j = int(a.eventq_index), int(b.eventq_index)
+        if i != j:
+            matrix[i * n + j] = min(matrix[i * n + j], latency)
+    return matrix
@@ -0,0 +1,199 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Automatically assigns the SimObjects of a configuration to main event
+# queues.
+#
+# The hierarchy is first split into units: the subtrees hanging from
+# container objects (Root, System, SubSystem), which are always simulated
+# on queue 0. A unit is never split, as objects usually call into their
+# children directly. Units that must share a queue, because they are
+# connected with no latency or refer to each other through parameters,
+# are merged. The remaining connections are then cut from the highest
+# latency down, keeping the lowest latency ones inside a queue, as long
+# as there are more groups than queues and the groups stay balanced.
+# Finally the groups are packed into the queues by estimated event rate.
+
+import os
+
+from m5.util import inform, warn
+from m5.util.eventq_graph import link_graph, MaxTick
+
+class _UnionFind(object):
+    def __init__(self, n):
+        self.parent = list(range(n))
+
+    def find(self, i):
+        while self.parent[i] != i:
+            self.parent[i] = self.parent[self.parent[i]]
+            i = self.parent[i]
+        return i
+
+    def union(self, i, j):
+        i, j = self.find(i), self.find(j)
+        # keep the lowest index as the representative for determinism
+        if i > j:
+            i, j = j, i
+        self.parent[j] = i
+        return i
+
+def _units(root):
+    """Return the list of units, as lists of SimObjects, and a dictionary
+    mapping the id of every object in a unit to the index of its unit."""
+    units = []
+    unit_of = {}
+
+    def visit(obj):
+        for name, child in sorted(obj._children.items()):
+            for c in (child if isinstance(child, list) else [child]):
+                if c.isEventQueueContainer():
+                    visit(c)
+                    continue
+                index = len(units)
+                units.append(list(c.descendants()))
+                for d in units[-1]:
+                    unit_of.setdefault(id(d), index)
+
+    visit(root)
+    return units, unit_of
+
+def _param_refs(obj):
+    from m5.SimObject import SimObject
+    for value in obj._values.values():
+        for v in (value if isinstance(value, (list, tuple)) else [value]):
+            if isinstance(v, SimObject):
+                yield v
+
+def partition(root, num_queues, imbalance=1.25):
+    """Assign an eventq_index to every object under root, using up to
+    num_queues queues, and return the list of (object, object, latency)
+    connections that are cut between queues."""
+    units, unit_of = _units(root)
+    n = len(units)
+    uf = _UnionFind(n)
+
+    weight = [ sum(o.eventRateEstimate() for o in unit) for unit in units ]
+    total = sum(weight)
+    capacity = imbalance * total / num_queues if total else 0
+
+    # Minimum latency of the connections between each pair of units
+    edges = {}
+    for (a, b), latency in link_graph(root).items():
+        ua, ub = unit_of.get(id(a)), unit_of.get(id(b))
+        if ua is None or ub is None or ua == ub:
+            continue
+        key = (min(ua, ub), max(ua, ub))
+        edges[key] = min(edges.get(key, MaxTick), latency)
+
+    # Mandatory merges: no latency to hide, or direct calls through a
+    # parameter (e.g., a cache pointing at a prefetcher of another unit)
+    groups = dict((i, weight[i]) for i in range(n))
+    def merge(i, j):
+        i, j = uf.find(i), uf.find(j)
+        if i == j:
+            return
+        w = groups.pop(i) + groups.pop(j)
+        groups[uf.union(i, j)] = w
+
+    for (ua, ub), latency in edges.items():
+        if latency == 0:
+            merge(ua, ub)
+    for i, unit in enumerate(units):
+        for obj in unit:
+            for ref in _param_refs(obj):
+                j = unit_of.get(id(ref))
+                if j is not None and j != i and \
+                   not ref.isEventQueueShared():
+                    merge(i, j)
+
+    # Keep the lowest latency connections within a queue
+    for (ua, ub), latency in sorted(edges.items(),
+                                    key=lambda e: (e[1], e[0])):
+        if len(groups) <= num_queues:
+            break
+        i, j = uf.find(ua), uf.find(ub)
+        if i != j and (not capacity or groups[i] + groups[j] <= capacity):
+            merge(i, j)
+
+    # Pack the groups, heaviest first, into the least loaded queue.
+    # Groups with no connection to any other unit stay on queue 0.
+    connected = set()
+    for ua, ub in edges:
+        connected.add(uf.find(ua))
+        connected.add(uf.find(ub))
+    load = [ 0.0 ] * num_queues
+    queue_of = {}
+    for g in sorted(groups, key=lambda g: (-groups[g], g)):
+        if g not in connected:
+            queue_of[g] = 0
+            continue
+        q = min(range(num_queues), key=lambda q: (load[q], q))
+        queue_of[g] = q
+        load[q] += groups[g]
+
+    for obj in root.descendants():
+        u = unit_of.get(id(obj))
+        obj.eventq_index = queue_of[uf.find(u)] if u is not None else 0
+
+    # Report each cut connection once, with the latency of its fastest
+    # direction
+    cuts = {}
+    for (a, b), latency in link_graph(root).items():
+        if int(a.eventq_index) == int(b.eventq_index):
+            continue
+        key = (a, b) if str(a) < str(b) else (b, a)
+        cuts[key] = min(cuts.get(key, MaxTick), latency)
+    return [ (a, b, latency) for (a, b), latency in cuts.items() ]
+
+def write_report(root, num_queues, cuts, outdir, filename):
+    """Write the assignment of units to queues and the cut connections,
+    and return the minimum cut latency (MaxTick if nothing is cut)."""
+    min_cut = min([ latency for a, b, latency in cuts ] + [ MaxTick ])
+
+    with open(os.path.join(outdir, filename), 'w') as f:
+        units, _ = _units(root)
+        for q in range(num_queues):
+            members = [ u[0] for u in units if int(u[0].eventq_index) == q ]
+            rate = sum(o.eventRateEstimate()
+                       for u in units if int(u[0].eventq_index) == q
+                       for o in u)
+            print("eventq %d: %d units, estimated event rate %g" %
+                  (q, len(members), rate), file=f)
+            for obj in members:
+                print("    %s" % obj.path(), file=f)
+        print("cut connections:", file=f)
+        for a, b, latency in sorted(cuts, key=lambda c: (c[2], str(c[0]))):
+            print("    %s <-> %s: %d ticks (eventq %d <-> %d)" %
+                  (a.path(), b.path(), latency,
+                   int(a.eventq_index), int(b.eventq_index)), file=f)
+
+    used = len(set(int(o.eventq_index) for o in root.descendants()))
+    if used < num_queues:
+        warn("Only %d of %d event queues could be used, the rest of "
+             "the system is too tightly coupled." % (used, num_queues))
+    if min_cut == MaxTick:
+        inform("Event queue partition: nothing cut, see %s" % filename)
+    else:
+        inform("Event queue partition: %d connections cut, minimum "
+               "latency %d ticks, see %s" % (len(cuts), min_cut, filename))
+    return min_cut
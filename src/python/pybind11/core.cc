@@ -294,6 +294,10 @@ pybind_init_core(py::module_ &m_native)
      */
     m_core
         .def("serializeAll", &SimObject::serializeAll)
+        .def("writeCheckpointIndex", &CheckpointIn::writeIndex)
+        .def("writeCheckpointIndex", []() {
+            return CheckpointIn::writeIndex(CheckpointIn::dir());
+        })
         .def("getCheckpoint", [](const std::string &cpt_dir) {
             SimObject::setSimObjectResolver(&pybindSimObjectResolver);
             return new CheckpointIn(cpt_dir);
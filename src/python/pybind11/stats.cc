@@ -42,6 +42,7 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/columnar.hh"
 #include "base/stats/text.hh"
 #include "config/have_hdf5.hh"
 
@@ -115,6 +116,8 @@ pybind_init_stats(py::module_ &m_native)
 #if HAVE_HDF5
         .def("initHDF5", &statistics::initHDF5)
 #endif
+        .def("initColumnar", &statistics::initColumnar)
+        .def("initColumnarSnapshot", &statistics::initColumnarSnapshot)
         .def("registerPythonStatsHandlers",
              &statistics::registerPythonStatsHandlers)
         .def("schedStatEvent", &statistics::schedStatEvent)
@@ -125,6 +128,9 @@ pybind_init_stats(py::module_ &m_native)
         .def("enable", &statistics::enable)
         .def("enabled", &statistics::enabled)
         .def("statsList", &statistics::statsList)
+        .def("visitGroup", &statistics::visitGroup,
+             py::arg("group"), py::arg("output"), py::arg("threads") = 1,
+             py::call_guard<py::gil_scoped_release>())
         ;
 
     py::class_<statistics::Output>(m, "Output")
@@ -135,6 +141,13 @@ pybind_init_stats(py::module_ &m_native)
         .def("endGroup", &statistics::Output::endGroup)
         ;
 
+    py::class_<statistics::ColumnarSnapshot, statistics::Output>(
+        m, "ColumnarSnapshot")
+        .def("take", &statistics::ColumnarSnapshot::take)
+        .def("flush", &statistics::ColumnarSnapshot::flush)
+        .def("size", &statistics::ColumnarSnapshot::size)
+        ;
+
     py::class_<statistics::Info,
         std::unique_ptr<statistics::Info, py::nodelete>>(m, "Info")
         .def_readwrite("name", &statistics::Info::name)
@@ -44,6 +44,9 @@ class ClockDomain(SimObject):
     cxx_class = 'gem5::ClockDomain'
     abstract = True
 
+    def isEventQueueShared(self):
+        return True
+
 # Source clock domain with an actual clock, and a list of voltage and frequency
 # op points
 class SrcClockDomain(ClockDomain):
@@ -70,6 +73,10 @@ class SrcClockDomain(ClockDomain):
     # Defaults to maximum performance
     init_perf_level = Param.UInt32(0, "Initial performance level")
 
+    # Shortest clock period, in ticks, across all performance levels
+    def clockPeriod(self):
+        return min(clock.getValue() for clock in self.clock)
+
 # Derived clock domain with a parent clock domain and a frequency
 # divider
 class DerivedClockDomain(ClockDomain):
@@ -79,3 +86,6 @@ class DerivedClockDomain(ClockDomain):
 
     clk_domain = Param.ClockDomain("Parent clock domain")
     clk_divider = Param.Unsigned(1, "Frequency divider")
+
+    def clockPeriod(self):
+        return self.clk_domain.clockPeriod() * int(self.clk_divider)
@@ -53,3 +53,12 @@ class ClockedObject(SimObject):
 
     power_state = Param.PowerState(PowerState(), "Power state")
 
+    # Convert a number of cycles of this object to ticks. Only valid once
+    # the clock domain has been resolved, e.g. at instantiation.
+    def cyclesToTicks(self, cycles):
+        return int(cycles) * self.clk_domain.clockPeriod()
+
+    # Assume one event per cycle
+    def eventRateEstimate(self):
+        return 1.0 / self.clk_domain.clockPeriod()
+
@@ -30,6 +30,12 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+class EventQueueScheduler(ScopedEnum):
+    vals = ['list', 'calendar']
+
+class EventQueueSync(ScopedEnum):
+    vals = ['quantum', 'conservative']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -55,6 +61,9 @@ class Root(SimObject):
     def path(self):
         return 'root'
 
+    def isEventQueueContainer(self):
+        return True
+
     type = 'Root'
     cxx_header = "sim/root.hh"
     cxx_class = 'gem5::Root'
@@ -67,6 +76,39 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Data structure keeping the pending events of the main event queues.
+    # The calendar queue has O(1) amortized scheduling cost, which pays
+    # off when many distinct ticks are pending at the same time.
+    eventq_scheduler = Param.EventQueueScheduler('list',
+        "data structure used by the main event queues")
+
+    # Synchronization of multiple main event queues. With 'quantum' the
+    # queues wait for each other every sim_quantum ticks. With
+    # 'conservative' they advance in windows bounded by the latency of
+    # the links between them. The events they schedule in each other are
+    # merged in a fixed order, but the simulation is still not
+    # deterministic, as timing requests run the receiver's code on the
+    # sender's thread.
+    eventq_sync = Param.EventQueueSync('quantum',
+        "synchronization of multiple main event queues")
+    # Minimum latency of the links from each main event queue to each
+    # other, flattened in source major order, MaxTick if they are not
+    # connected. It is computed from the SimObject graph when empty.
+    eventq_lookahead = VectorParam.Tick([],
+        "lookahead between main event queues (conservative sync)")
+    # Split the system into this many main event queues at instantiate
+    # time, overriding the eventq_index of the objects. The partition and
+    # the latency of the connections it cuts are reported in
+    # eventq_partition.txt.
+    eventq_partitions = Param.Unsigned(0,
+        "number of main event queues to partition the system into, "
+        "0 to keep the eventq_index set by the configuration")
+
+    # Profile the host time spent in every event and object, see
+    # event_profile.txt and event_profile.folded in the output directory.
+    event_profile = Param.Bool(False,
+        "profile the host time spent servicing events")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
@@ -0,0 +1,51 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+
+class StatConvergence(SimObject):
+    """Stops the simulation once the monitored stats have converged.
+
+    The stats are sampled every interval, without dumping them. They are
+    considered converged when the last window samples of each of them are
+    within tolerance of their mean, e.g. when the IPC estimate of the run
+    doesn't move by more than 1% anymore. The simulation loop then exits
+    with the cause "stats converged", once. Resetting the stats starts
+    monitoring them again.
+    """
+
+    type = 'StatConvergence'
+    cxx_header = "sim/stat_convergence.hh"
+    cxx_class = 'gem5::StatConvergence'
+
+    stats = VectorParam.String("Full names of the scalar, vector or formula "
+        "stats to monitor, e.g. system.cpu.ipc")
+    interval = Param.Latency("1ms", "Time between two samples of the stats")
+    window = Param.Unsigned(10, "Number of consecutive samples which have "
+        "to agree")
+    tolerance = Param.Float(0.01, "Maximum spread of the samples of a "
+        "window relative to their mean")
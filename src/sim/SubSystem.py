@@ -54,4 +54,7 @@ class SubSystem(SimObject):
     # clock domain by default
     thermal_domain = Param.ThermalDomain(NULL, "Thermal domain")
 
+    def isEventQueueContainer(self):
+        return True
+
     generateDeviceTree = SimObject.recurseDeviceTree
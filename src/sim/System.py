@@ -48,6 +48,8 @@ from m5.objects.Workload import StubWorkload
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemoryCheckpointFormat(ScopedEnum): vals = ['gzip', 'sparse']
+
 class System(SimObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -68,6 +70,9 @@ class System(SimObject):
     thermal_components = VectorParam.SimObject([],
             "A collection of all thermal components in the system.")
 
+    def isEventQueueContainer(self):
+        return True
+
     # When reserving memory on the host, we have the option of
     # reserving swap space or not (by passing MAP_NORESERVE to
     # mmap). By enabling this flag, we accommodate cases where a large
@@ -91,6 +96,22 @@ class System(SimObject):
         "shmem segment file upon destruction. This is used only if "
         "shared_backstore is non-empty.")
 
+    # The gzip format compresses the whole memory in a single stream. The
+    # sparse format writes the non-zero pages, in parallel, to a raw file
+    # with holes for the zero pages, and is restored by mapping the file
+    # copy-on-write in place of the backing store. It is much faster on
+    # large memories, and the file system only stores the non-zero pages.
+    memory_checkpoint_format = Param.MemoryCheckpointFormat('gzip',
+        "Format of the memory contents in checkpoints")
+
+    # Delta checkpoints only contain the pages written since the previous
+    # checkpoint, taken or restored, and refer to it. Restoring one
+    # restores the whole chain, so the checkpoints of a chain must be kept
+    # together. The written pages are tracked by the host kernel (Linux
+    # soft-dirty bits); full checkpoints are taken when it is unavailable.
+    memory_checkpoint_max_deltas = Param.Unsigned(0, "Maximum number of "
+        "delta memory checkpoints between two full ones (0 disables deltas)")
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
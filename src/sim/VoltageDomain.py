@@ -48,3 +48,6 @@ class VoltageDomain(SimObject):
     # descending order. We use a default voltage of 1V to avoid forcing users to
     # set it even if they are not interested in using the functionality
     voltage = VectorParam.Voltage('1V', "Operational voltage(s)")
+
+    def isEventQueueShared(self):
+        return True
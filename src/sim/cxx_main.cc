@@ -0,0 +1,325 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Entry point of gem5-cxx, a gem5 binary which doesn't embed Python.
+ *  It instantiates the config.ini written by a previous (Python) run of
+ *  the same build, optionally restores a checkpoint, and simulates, so
+ *  that sweeps of many short runs of the same configuration don't pay
+ *  for the Python configuration scripts each time.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "base/stats/group.hh"
+#include "base/stats/text.hh"
+#include "base/str.hh"
+#include "base/trace.hh"
+#include "sim/core.hh"
+#include "sim/cxx_config_ini.hh"
+#include "sim/cxx_manager.hh"
+#include "sim/drain.hh"
+#include "sim/init_signals.hh"
+#include "sim/root.hh"
+#include "sim/serialize.hh"
+#include "sim/sim_events.hh"
+#include "sim/sim_exit.hh"
+#include "sim/simulate.hh"
+#include "sim/stat_control.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Output of the stats dumps, set up after parsing the options. */
+statistics::Output *statsOutput = nullptr;
+
+/** Tick of the last stats dump, to dump at most once per tick. */
+Tick lastDump = 0;
+
+[[noreturn]] void
+usage(const std::string &prog_name)
+{
+    std::cerr << "Usage: " << prog_name << (
+        " [ <option> ] <config-file.ini>\n\n"
+        "Instantiate and simulate the config.ini written by a previous run\n"
+        "of gem5, without starting Python.\n\n"
+        "OPTIONS:\n"
+        "    -o <dir>                     -- output directory (m5out)\n"
+        "    -S <file>                    -- stats file in the output\n"
+        "                                    directory (stats.txt)\n"
+        "    -p <object> <param> <value>  -- set a parameter\n"
+        "    -v <object> <param> <values> -- set a vector parameter from"
+        " a comma\n"
+        "                                    separated values string\n"
+        "    -d <flags>                   -- set comma separated debug"
+        " flags\n"
+        "                                    (-<flag> clears a flag)\n"
+        "    -r <dir>                     -- restore checkpoint from dir\n"
+        "    -m <tick>                    -- stop simulating at tick\n"
+        "\n"
+        );
+
+    std::exit(EXIT_FAILURE);
+}
+
+/** Call a function on all the stats of a group hierarchy. */
+template <typename F>
+void
+forEachStat(const statistics::Group &group, F f)
+{
+    for (auto *info : group.getStats())
+        f(info);
+    for (const auto &g : group.getStatGroups())
+        forEachStat(*g.second, f);
+}
+
+void
+enableStats()
+{
+    auto check_and_enable = [](statistics::Info *info) {
+        if (!info->check() || !info->baseCheck()) {
+            fatal("statistic '%s' (%d) was not properly initialized "
+                  "by a regStats() function\n", info->name, info->id);
+        }
+        info->enable();
+    };
+
+    for (auto *info : statistics::statsList())
+        check_and_enable(info);
+    forEachStat(*Root::root(), check_and_enable);
+
+    statistics::enable();
+}
+
+void
+dumpStats()
+{
+    // Don't allow multiple stat dumps in the same tick.
+    if (lastDump == curTick())
+        return;
+    lastDump = curTick();
+
+    statistics::processDumpQueue();
+    Root::root()->preDumpStats();
+
+    for (auto *info : statistics::statsList())
+        info->prepare();
+    forEachStat(*Root::root(), [](statistics::Info *info) {
+        info->prepare();
+    });
+
+    if (!statsOutput->valid())
+        return;
+
+    statsOutput->begin();
+    for (auto *info : statistics::statsList())
+        info->visit(*statsOutput);
+    statistics::visitGroup(*Root::root(), *statsOutput);
+    statsOutput->end();
+}
+
+void
+resetStats()
+{
+    Root::root()->resetStats();
+
+    for (auto *info : statistics::statsList())
+        info->reset();
+
+    statistics::processResetQueue();
+}
+
+/** Drain the system, simulating until all the objects are drained. */
+void
+drain()
+{
+    while (!DrainManager::instance().tryDrain())
+        simulate();
+}
+
+/**
+ * Write a checkpoint at the current tick, in the same place and the
+ * same way as the checkpoint exit events of configs/common/Simulation.py.
+ */
+void
+checkpoint(CxxConfigManager &config_manager)
+{
+    drain();
+    config_manager.forEachObject(&SimObject::memWriteback);
+
+    std::string dir = simout.resolve(csprintf("cpt.%d", curTick()));
+    std::cout << "Writing checkpoint " << dir << "\n";
+    SimObject::serializeAll(dir);
+
+    DrainManager::instance().resume();
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+    std::string prog_name(argv[0]);
+    int arg_ptr = 1;
+
+    initSignals();
+
+    // Like m5.ticks, the config.ini is written in ticks of 1 ps.
+    setClockFrequency(1000000000000);
+    fixClockFrequency();
+    curEventQueue(getEventQueue(0));
+
+    statistics::initSimStats();
+    statistics::registerHandlers(resetStats, dumpStats);
+
+    std::string outdir = "m5out";
+    std::string stats_file = "stats.txt";
+    std::string checkpoint_dir;
+    Tick max_tick = MaxTick;
+    std::vector<std::vector<std::string>> param_options;
+
+    while (arg_ptr < argc - 1) {
+        std::string option(argv[arg_ptr]);
+        arg_ptr++;
+        int num_args = argc - 1 - arg_ptr;
+
+        if (option == "-o") {
+            if (num_args < 1)
+                usage(prog_name);
+            outdir = argv[arg_ptr++];
+        } else if (option == "-S") {
+            if (num_args < 1)
+                usage(prog_name);
+            stats_file = argv[arg_ptr++];
+        } else if (option == "-p" || option == "-v") {
+            if (num_args < 3)
+                usage(prog_name);
+            param_options.push_back({option, argv[arg_ptr],
+                argv[arg_ptr + 1], argv[arg_ptr + 2]});
+            arg_ptr += 3;
+        } else if (option == "-d") {
+            if (num_args < 1)
+                usage(prog_name);
+            std::vector<std::string> flags;
+            tokenize(flags, argv[arg_ptr++], ',');
+            for (const auto &flag : flags) {
+                if (flag[0] == '-')
+                    clearDebugFlag(flag.c_str() + 1);
+                else
+                    setDebugFlag(flag.c_str());
+            }
+        } else if (option == "-r") {
+            if (num_args < 1)
+                usage(prog_name);
+            checkpoint_dir = argv[arg_ptr++];
+        } else if (option == "-m") {
+            if (num_args < 1 || !to_number(argv[arg_ptr++], max_tick))
+                usage(prog_name);
+        } else {
+            usage(prog_name);
+        }
+    }
+
+    if (arg_ptr != argc - 1)
+        usage(prog_name);
+    const std::string config_file(argv[arg_ptr]);
+
+    setOutputDir(outdir);
+    Trace::enable();
+    statsOutput = statistics::initText(stats_file, true, true);
+
+    CxxIniFile conf;
+    if (!conf.load(config_file)) {
+        std::cerr << "Can't open config file: " << config_file << '\n';
+        return EXIT_FAILURE;
+    }
+
+    CxxConfigManager config_manager(conf);
+
+    try {
+        for (const auto &option : param_options) {
+            if (option[0] == "-p") {
+                config_manager.setParam(option[1], option[2], option[3]);
+            } else {
+                std::vector<std::string> values;
+                tokenize(values, option[3], ',');
+                config_manager.setParamVector(option[1], option[2], values);
+            }
+        }
+
+        config_manager.instantiate();
+        enableStats();
+
+        if (checkpoint_dir.empty()) {
+            config_manager.initState();
+            config_manager.startup();
+        }
+    } catch (CxxConfigManager::Exception &e) {
+        std::cerr << "Config problem in sim object " << e.name
+            << ": " << e.message << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!checkpoint_dir.empty()) {
+        std::cout << "Restoring checkpoint " << checkpoint_dir << "\n";
+
+        SimObject::setSimObjectResolver(
+            &config_manager.getSimObjectResolver());
+        CheckpointIn checkpoint(checkpoint_dir);
+
+        DrainManager::instance().preCheckpointRestore();
+        config_manager.loadState(checkpoint);
+        config_manager.startup();
+        config_manager.drainResume();
+    }
+
+    std::cout << "**** REAL SIMULATION ****\n";
+
+    GlobalSimLoopExitEvent *exit_event = nullptr;
+    while (true) {
+        exit_event = simulate(max_tick - curTick());
+        if (exit_event->getCause() != "checkpoint")
+            break;
+        checkpoint(config_manager);
+    }
+
+    std::cout << "Exiting @ tick " << curTick() << " because "
+        << exit_event->getCause() << "\n";
+
+    int code = exit_event->getCode();
+    dumpStats();
+    doExitCleanup();
+    return code;
+}
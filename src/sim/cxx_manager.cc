@@ -602,8 +602,14 @@ CxxConfigManager::instantiate(bool build_all)
     DPRINTF(CxxConfig, "Initialising all objects\n");
     forEachObject(&SimObject::init);
 
+    DPRINTF(CxxConfig, "Binding the stat hierarchy\n");
+    std::list<SimObject *> stat_roots = bindStatHierarchy();
+
+    /* regStats recurses into the child groups, so only call it on the
+     *  objects which don't have a parent group */
     DPRINTF(CxxConfig, "Registering stats\n");
-    forEachObject(&SimObject::regStats);
+    for (auto i = stat_roots.begin(); i != stat_roots.end(); ++i)
+        (*i)->regStats();
 
     DPRINTF(CxxConfig, "Registering probe points\n");
     forEachObject(&SimObject::regProbePoints);
@@ -612,6 +618,56 @@ CxxConfigManager::instantiate(bool build_all)
     forEachObject(&SimObject::regProbeListeners);
 }
 
+std::list<SimObject *>
+CxxConfigManager::bindStatHierarchy()
+{
+    std::list<SimObject *> roots;
+
+    /* objectsInOrder is a preorder traversal, so the parents have been
+     *  visited when visiting their children */
+    for (auto i = objectsInOrder.begin(); i != objectsInOrder.end(); ++i) {
+        SimObject *object = *i;
+        const std::string &instance_name = object->name();
+
+        /* Attach the object to its closest instantiated ancestor, like
+         *  m5.stats._bindStatHierarchy does.  Elements of SimObject
+         *  vectors are already named name0, name1... */
+        SimObject *parent = nullptr;
+        std::size_t dot_i = instance_name.rfind('.');
+        std::string parent_name = dot_i == std::string::npos ?
+            "" : instance_name.substr(0, dot_i);
+        while (!parent && !parent_name.empty()) {
+            auto parent_i = objectsByName.find(parent_name);
+            if (parent_i != objectsByName.end()) {
+                parent = parent_i->second;
+            } else {
+                dot_i = parent_name.rfind('.');
+                parent_name = dot_i == std::string::npos ?
+                    "" : parent_name.substr(0, dot_i);
+            }
+        }
+
+        /* Top level objects (system...) are children of the root */
+        auto root_i = objectsByName.find("root");
+        if (!parent && root_i != objectsByName.end() &&
+            root_i->second != object) {
+            parent = root_i->second;
+        }
+
+        if (parent) {
+            DPRINTF(CxxConfig, "Adding stat group %s to %s\n",
+                instance_name, parent->name());
+            parent->addStatGroup(
+                instance_name.substr(instance_name.rfind('.') + 1).c_str(),
+                object);
+        } else {
+            roots.push_back(object);
+        }
+    }
+
+    return roots;
+}
+
 void
 CxxConfigManager::initState()
 {
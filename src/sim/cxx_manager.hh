@@ -277,6 +277,12 @@ class CxxConfigManager
      *  instantiate */
     void instantiate(bool build_all = true);
 
+    /** Add the stat group of each object to the stat group of its
+     *  parent, so that the stats are named after the object hierarchy as
+     *  they are when the config is instantiated from Python.  Returns the
+     *  objects which haven't been given a parent group */
+    std::list<SimObject *> bindStatHierarchy();
+
     /** Call initState on all objects */
     void initState();
 
@@ -0,0 +1,128 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Allocation of transient events from free lists
+ */
+
+#ifndef __SIM_EVENT_POOL_HH__
+#define __SIM_EVENT_POOL_HH__
+
+#include <cstddef>
+
+namespace gem5
+{
+
+/**
+ * Free list allocator for events created and deleted at a high rate
+ * (e.g., AutoDelete events allocated for every transaction).
+ *
+ * Blocks are grouped in a few size classes, and carved out of large
+ * slabs that are never returned to the system. There is one pool per
+ * host thread, so that an event queue always allocates from and frees
+ * to its own pool without locking. An event freed by another thread
+ * simply moves to the pool of that thread.
+ */
+class EventPool
+{
+  public:
+    /** Size granularity of the blocks. */
+    static constexpr size_t Granularity = 64;
+    /** Larger allocations go to the default allocator. */
+    static constexpr size_t MaxSize = 4 * Granularity;
+
+  private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    static constexpr size_t NumClasses = MaxSize / Granularity;
+    static constexpr size_t SlabSize = 64 * 1024;
+
+    Block *freeList[NumClasses] = {};
+
+    static size_t classOf(size_t size) { return (size - 1) / Granularity; }
+
+    /** Carve a new slab into blocks of a size class. */
+    void refill(size_t cls);
+
+  public:
+    /** Pool of the calling thread. */
+    static EventPool &local();
+
+    void *
+    allocate(size_t size)
+    {
+        if (size > MaxSize)
+            return ::operator new(size);
+
+        size_t cls = classOf(size);
+        if (!freeList[cls])
+            refill(cls);
+        Block *block = freeList[cls];
+        freeList[cls] = block->next;
+        return block;
+    }
+
+    void
+    deallocate(void *p, size_t size)
+    {
+        if (size > MaxSize) {
+            ::operator delete(p);
+            return;
+        }
+
+        size_t cls = classOf(size);
+        Block *block = static_cast<Block *>(p);
+        block->next = freeList[cls];
+        freeList[cls] = block;
+    }
+};
+
+/**
+ * Base class making the heap allocations of an event class go through
+ * the EventPool of the current thread. The class must have a virtual
+ * destructor (as all Events do) for the pool to get the right size back.
+ */
+class EventPoolAllocated
+{
+  public:
+    static void *
+    operator new(size_t size)
+    {
+        return EventPool::local().allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        EventPool::local().deallocate(p, size);
+    }
+};
+
+} // namespace gem5
+
+#endif // __SIM_EVENT_POOL_HH__
@@ -0,0 +1,102 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sim/event_pool.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+/** Freed blocks are reused by allocations of the same size class. */
+TEST(EventPoolTest, Reuse)
+{
+    EventPool &pool = EventPool::local();
+
+    void *a = pool.allocate(100);
+    void *b = pool.allocate(128);
+    EXPECT_NE(a, b);
+    pool.deallocate(a, 100);
+    EXPECT_EQ(pool.allocate(120), a);
+
+    // Different size classes do not share blocks
+    void *c = pool.allocate(32);
+    EXPECT_NE(c, a);
+    EXPECT_NE(c, b);
+
+    pool.deallocate(a, 120);
+    pool.deallocate(b, 128);
+    pool.deallocate(c, 32);
+}
+
+/** Allocations above the largest size class still work. */
+TEST(EventPoolTest, Large)
+{
+    EventPool &pool = EventPool::local();
+    void *p = pool.allocate(EventPool::MaxSize + 1);
+    ASSERT_NE(p, nullptr);
+    pool.deallocate(p, EventPool::MaxSize + 1);
+}
+
+/** Callbacks run in order and their state is released afterwards. */
+TEST(EventPoolTest, ScheduleCallback)
+{
+    EventQueue eq("test_eq");
+    std::vector<int> trace;
+    auto token = std::make_shared<int>(0);
+
+    eq.scheduleCallback([&trace, token]{ trace.push_back(2); }, 20);
+    eq.scheduleCallback([&trace, token]{ trace.push_back(1); }, 10,
+                        "first");
+    eq.scheduleCallback([&trace, token]{ trace.push_back(0); }, 10,
+                        "urgent", Event::Maximum_Pri - 1);
+    EXPECT_EQ(eq.getHead()->name(), "first");
+    EXPECT_EQ(token.use_count(), 4);
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(trace, std::vector<int>({1, 0, 2}));
+    EXPECT_EQ(token.use_count(), 1);
+}
+
+/** Descheduling a callback deletes it without calling it. */
+TEST(EventPoolTest, DescheduleCallback)
+{
+    EventQueue eq("test_eq");
+    bool called = false;
+    auto token = std::make_shared<int>(0);
+
+    eq.scheduleCallback([&called, token]{ called = true; }, 10);
+    eq.deschedule(eq.getHead());
+
+    EXPECT_TRUE(eq.empty());
+    EXPECT_FALSE(called);
+    EXPECT_EQ(token.use_count(), 1);
+}
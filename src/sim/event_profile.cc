@@ -0,0 +1,186 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profile.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+bool profileEnabled = false;
+
+/** Name of the owner of an event, "" for top level events. */
+std::string
+ownerOf(const std::string &name)
+{
+    auto pos = name.rfind('.');
+    return pos == std::string::npos ? "" : name.substr(0, pos);
+}
+
+template <class Map>
+std::vector<typename Map::const_iterator>
+sortedByTime(const Map &map)
+{
+    std::vector<typename Map::const_iterator> sorted;
+    for (auto it = map.begin(); it != map.end(); ++it)
+        sorted.push_back(it);
+    std::sort(sorted.begin(), sorted.end(), [](auto l, auto r) {
+        return l->second.hostNs != r->second.hostNs ?
+            l->second.hostNs > r->second.hostNs : l->first < r->first;
+    });
+    return sorted;
+}
+
+} // anonymous namespace
+
+void
+EventProfile::process(Event *event)
+{
+    // The default event name is unique to each event instance, group
+    // these events by type instead.
+    std::string name = event->name();
+    if (name.compare(0, 6, "Event_") == 0)
+        name = csprintf("Event_%s", event->description());
+    Entry &entry = entries[name];
+    entry.description = event->description();
+
+    // The event may be deleted when processed, so don't touch it after.
+    auto start = std::chrono::steady_clock::now();
+    event->process();
+    auto end = std::chrono::steady_clock::now();
+
+    entry.count++;
+    entry.hostNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - start).count();
+}
+
+void
+EventProfile::merge(const EventProfile &other)
+{
+    for (const auto &[name, e] : other.entries) {
+        Entry &entry = entries[name];
+        entry.count += e.count;
+        entry.hostNs += e.hostNs;
+        entry.description = e.description;
+    }
+}
+
+void
+EventProfile::dump(std::ostream &os) const
+{
+    uint64_t total_ns = 0, total_count = 0;
+    std::map<std::string, Entry> owners;
+    for (const auto &[name, e] : entries) {
+        total_ns += e.hostNs;
+        total_count += e.count;
+        Entry &owner = owners[ownerOf(name)];
+        owner.count += e.count;
+        owner.hostNs += e.hostNs;
+    }
+
+    auto line = [&os, total_ns](const Entry &e) {
+        ccprintf(os, "%12.3f %6.2f%% %12d %10.1f ", e.hostNs / 1e6,
+                 total_ns ? 100.0 * e.hostNs / total_ns : 0.0, e.count,
+                 e.count ? double(e.hostNs) / e.count : 0.0);
+    };
+
+    ccprintf(os, "# Host time in events: %.3f ms, %d events\n",
+             total_ns / 1e6, total_count);
+    ccprintf(os, "\n# Per object\n");
+    ccprintf(os, "# %10s %7s %12s %10s %s\n",
+             "host ms", "share", "events", "ns/event", "object");
+    for (auto it : sortedByTime(owners)) {
+        line(it->second);
+        ccprintf(os, "%s\n", it->first.empty() ? "(none)" : it->first);
+    }
+
+    ccprintf(os, "\n# Per event\n");
+    ccprintf(os, "# %10s %7s %12s %10s %s\n",
+             "host ms", "share", "events", "ns/event", "event (type)");
+    for (auto it : sortedByTime(entries)) {
+        line(it->second);
+        ccprintf(os, "%s (%s)\n", it->first, it->second.description);
+    }
+}
+
+void
+EventProfile::dumpFolded(std::ostream &os) const
+{
+    for (auto it : sortedByTime(entries)) {
+        std::string stack = it->first;
+        std::replace(stack.begin(), stack.end(), '.', ';');
+        ccprintf(os, "%s %d\n", stack, it->second.hostNs);
+    }
+}
+
+void
+enableEventProfile()
+{
+    if (profileEnabled)
+        return;
+    profileEnabled = true;
+
+    for (auto *eq : mainEventQueue)
+        eq->enableProfile();
+}
+
+bool
+eventProfileEnabled()
+{
+    return profileEnabled;
+}
+
+EventProfile
+mainEventProfile()
+{
+    EventProfile profile;
+    for (auto *eq : mainEventQueue) {
+        if (eq->getProfile())
+            profile.merge(*eq->getProfile());
+    }
+    return profile;
+}
+
+void
+resetEventProfile()
+{
+    for (auto *eq : mainEventQueue) {
+        if (eq->getProfile())
+            eq->getProfile()->reset();
+    }
+}
+
+} // namespace gem5
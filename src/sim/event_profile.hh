@@ -0,0 +1,104 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Host time profiling of the events serviced by the event queues
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+
+namespace gem5
+{
+
+class Event;
+
+/**
+ * Host time and number of events serviced by an event queue, per event
+ * name. The owner of an event is the object its name is derived from,
+ * i.e., the part of the name before the last '.'.
+ *
+ * Profiling calls the virtual Event::name() for every event, so it slows
+ * the simulation down noticeably and is only enabled on request.
+ */
+class EventProfile
+{
+  public:
+    struct Entry
+    {
+        uint64_t count = 0;
+        uint64_t hostNs = 0;
+        const char *description = "";
+    };
+
+  private:
+    std::unordered_map<std::string, Entry> entries;
+
+  public:
+    /** Process an event, accounting for the host time it took. */
+    void process(Event *event);
+
+    /** Add the entries of another profile to this one. */
+    void merge(const EventProfile &other);
+
+    void reset() { entries.clear(); }
+
+    const std::unordered_map<std::string, Entry> &
+    getEntries() const
+    {
+        return entries;
+    }
+
+    /**
+     * Write a report sorted by host time, per event and per owner.
+     */
+    void dump(std::ostream &os) const;
+
+    /**
+     * Write the profile in the folded stack format of flame graph tools,
+     * the object hierarchy forming the stack, weighted by host time.
+     */
+    void dumpFolded(std::ostream &os) const;
+};
+
+/** Enable profiling of all the main event queues, present and future. */
+void enableEventProfile();
+
+bool eventProfileEnabled();
+
+/** Profile of all the main event queues merged together. */
+EventProfile mainEventProfile();
+
+/** Reset the profile of the main event queues. */
+void resetEventProfile();
+
+} // namespace gem5
+
+#endif // __SIM_EVENT_PROFILE_HH__
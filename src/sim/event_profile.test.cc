@@ -0,0 +1,113 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "sim/event_profile.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class GenericEvent : public Event
+{
+  public:
+    int processed = 0;
+    void process() override { processed++; }
+};
+
+} // anonymous namespace
+
+/** Events are accounted by name, generic ones by type. */
+TEST(EventProfileTest, Entries)
+{
+    EventQueue eq("test_eq");
+    eq.enableProfile();
+    ASSERT_NE(eq.getProfile(), nullptr);
+
+    int calls = 0;
+    EventFunctionWrapper tick([&calls]() { calls++; }, "system.cpu");
+    GenericEvent g0, g1;
+
+    eq.schedule(&tick, 10);
+    eq.schedule(&g0, 5);
+    eq.schedule(&g1, 6);
+    while (!eq.empty())
+        eq.serviceOne();
+    for (Tick t = 2; t <= 3; t++) {
+        eq.schedule(&tick, t * 10);
+        eq.serviceOne();
+    }
+
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(g0.processed + g1.processed, 2);
+
+    const auto &entries = eq.getProfile()->getEntries();
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries.at("system.cpu.wrapped_function_event").count, 3);
+    EXPECT_EQ(entries.at("Event_generic").count, 2);
+
+    EventProfile merged;
+    merged.merge(*eq.getProfile());
+    merged.merge(*eq.getProfile());
+    EXPECT_EQ(merged.getEntries().at("Event_generic").count, 4);
+
+    eq.getProfile()->reset();
+    EXPECT_TRUE(eq.getProfile()->getEntries().empty());
+}
+
+/** The reports list every event and owner. */
+TEST(EventProfileTest, Dump)
+{
+    EventQueue eq("test_eq");
+    eq.enableProfile();
+
+    EventFunctionWrapper a([]() {}, "system.cpu0");
+    EventFunctionWrapper b([]() {}, "system.cpu1");
+    eq.schedule(&a, 1);
+    eq.schedule(&b, 2);
+    while (!eq.empty())
+        eq.serviceOne();
+
+    std::ostringstream report;
+    eq.getProfile()->dump(report);
+    EXPECT_NE(report.str().find("2 events"), std::string::npos);
+    EXPECT_NE(report.str().find("system.cpu0\n"), std::string::npos);
+    EXPECT_NE(report.str().find(
+                "system.cpu1.wrapped_function_event (EventFunctionWrapped)"),
+              std::string::npos);
+
+    std::ostringstream folded;
+    eq.getProfile()->dumpFolded(folded);
+    EXPECT_NE(folded.str().find("system;cpu0;wrapped_function_event "),
+              std::string::npos);
+    EXPECT_NE(folded.str().find("system;cpu1;wrapped_function_event "),
+              std::string::npos);
+}
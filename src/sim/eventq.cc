@@ -58,18 +58,32 @@ std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+static EventSchedulerFactory mainEventQueueScheduler;
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
     while (numMainEventQueues <= index) {
         numMainEventQueues++;
-        mainEventQueue.push_back(
-            new EventQueue(csprintf("MainEventQueue-%d", index)));
+        EventQueue *eq = new EventQueue(csprintf("MainEventQueue-%d", index));
+        if (mainEventQueueScheduler)
+            eq->setScheduler(mainEventQueueScheduler());
+        if (eventProfileEnabled())
+            eq->enableProfile();
+        mainEventQueue.push_back(eq);
     }
 
     return mainEventQueue[index];
 }
 
+void
+setMainEventQueueScheduler(const EventSchedulerFactory &factory)
+{
+    mainEventQueueScheduler = factory;
+    for (auto *eq : mainEventQueue)
+        eq->setScheduler(factory());
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -111,24 +125,7 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
-    // Deal with the head case
-    if (!head || *event <= *head) {
-        head = Event::insertBefore(event, head);
-        return;
-    }
-
-    // Figure out either which 'in bin' list we are on, or where a new list
-    // needs to be inserted
-    Event *prev = head;
-    Event *curr = head->nextBin;
-    while (curr && *curr < *event) {
-        prev = curr;
-        curr = curr->nextBin;
-    }
-
-    // Note: this operation may render all nextBin pointers on the
-    // prev 'in bin' list stale (except for the top one)
-    prev->nextBin = Event::insertBefore(event, curr);
+    head = scheduler->insert(event);
 }
 
 Event *
@@ -170,28 +167,7 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
-    // deal with an event on the head's 'in bin' list (event has the same
-    // time as the head)
-    if (*head == *event) {
-        head = Event::removeItem(event, head);
-        return;
-    }
-
-    // Find the 'in bin' list that this event belongs on
-    Event *prev = head;
-    Event *curr = head->nextBin;
-    while (curr && *curr < *event) {
-        prev = curr;
-        curr = curr->nextBin;
-    }
-
-    if (!curr || *curr != *event)
-        panic("event not found!");
-
-    // curr points to the top item of the the correct 'in bin' list, when
-    // we remove an item, it returns the new top item (which may be
-    // unchanged)
-    prev->nextBin = Event::removeItem(event, curr);
+    head = scheduler->remove(event);
 }
 
 Event *
@@ -199,20 +175,8 @@ EventQueue::serviceOne()
 {
     std::lock_guard<EventQueue> lock(*this);
     Event *event = head;
-    Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
-
-    if (next) {
-        // update the next bin pointer since it could be stale
-        next->nextBin = head->nextBin;
-
-        // pop the stack
-        head = next;
-    } else {
-        // this was the only element on the 'in bin' list, so get rid of
-        // the 'in bin' list and point to the next bin list
-        head = head->nextBin;
-    }
+    head = scheduler->pop();
 
     // handle action
     if (!event->squashed()) {
@@ -220,7 +184,10 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (debug::Event)
             event->trace("executed");
-        event->process();
+        if (profile)
+            profile->process(event);
+        else
+            event->process();
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -295,16 +262,13 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        scheduler->forEachBin([](Event *nextBin) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
-        }
+        });
     }
 
     cprintf("============================================================\n");
@@ -316,27 +280,30 @@ EventQueue::debugVerify() const
     std::unordered_map<long, bool> map;
 
     Tick time = 0;
-    short priority = 0;
+    short priority = Event::Minimum_Pri;
+    bool ok = true;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    scheduler->forEachBin([&](Event *nextBin) {
         Event *nextInBin = nextBin;
-        while (nextInBin) {
+        while (ok && nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
                 nextInBin->dump();
-                return false;
+                ok = false;
+                return;
             } else if (nextInBin->when() == time &&
                        nextInBin->priority() < priority) {
                 cprintf("priority inverted!");
                 nextInBin->dump();
-                return false;
+                ok = false;
+                return;
             }
 
             if (map[reinterpret_cast<long>(nextInBin)]) {
                 cprintf("Node already seen");
                 nextInBin->dump();
-                return false;
+                ok = false;
+                return;
             }
             map[reinterpret_cast<long>(nextInBin)] = true;
 
@@ -345,21 +312,34 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
+    });
 
-        nextBin = nextBin->nextBin;
-    }
-
-    return true;
+    return ok;
 }
 
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    Event* t = scheduler->replaceHead(s);
+    head = scheduler->head();
     return t;
 }
 
+void
+EventQueue::enableProfile()
+{
+    if (!profile)
+        profile = std::make_unique<EventProfile>();
+}
+
+void
+EventQueue::setScheduler(std::unique_ptr<EventScheduler> sched)
+{
+    sched->replaceHead(scheduler->replaceHead(nullptr));
+    scheduler = std::move(sched);
+    head = scheduler->head();
+}
+
 void
 dumpMainQueue()
 {
@@ -416,7 +396,8 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0),
+      scheduler(std::make_unique<ListEventScheduler>())
 {
 }
 
@@ -424,7 +405,7 @@ void
 EventQueue::asyncInsert(Event *event)
 {
     async_queue_mutex.lock();
-    async_queue.push_back(event);
+    async_queue.emplace_back(event, curEventQueue());
     async_queue_mutex.unlock();
 }
 
@@ -435,11 +416,50 @@ EventQueue::handleAsyncInsertions()
     async_queue_mutex.lock();
 
     while (!async_queue.empty()) {
-        insert(async_queue.front());
+        insert(async_queue.front().first);
         async_queue.pop_front();
     }
 
     async_queue_mutex.unlock();
 }
 
+size_t
+EventQueue::handleAsyncInsertionsOrdered(Tick min_when)
+{
+    assert(this == curEventQueue());
+    std::lock_guard<UncontendedMutex> lock(async_queue_mutex);
+
+    if (async_queue.empty())
+        return 0;
+
+    std::unordered_map<const EventQueue *, uint32_t> rank;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        rank[mainEventQueue[i]] = i;
+
+    // Each source queue adds its events in a deterministic order, only
+    // the interleaving of the sources depends on the host.
+    std::vector<std::pair<uint32_t, Event *>> events;
+    events.reserve(async_queue.size());
+    for (const auto &[event, source] : async_queue) {
+        auto it = rank.find(source);
+        events.emplace_back(
+            it == rank.end() ? numMainEventQueues : it->second, event);
+    }
+    async_queue.clear();
+
+    std::stable_sort(events.begin(), events.end(),
+        [](const auto &l, const auto &r) { return l.first < r.first; });
+
+    size_t delayed = 0;
+    for (auto &[source, event] : events) {
+        if (event->when() < min_when) {
+            event->setWhen(min_when, this);
+            delayed++;
+        }
+        insert(event);
+    }
+
+    return delayed;
+}
+
 } // namespace gem5
@@ -43,6 +43,8 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -50,6 +52,9 @@
 #include "base/uncontended_mutex.hh"
 #include "debug/Event.hh"
 #include "sim/cur_tick.hh"
+#include "sim/event_pool.hh"
+#include "sim/event_profile.hh"
+#include "sim/eventq_scheduler.hh"
 #include "sim/serialize.hh"
 
 namespace gem5
@@ -85,6 +90,10 @@ extern bool inParallelMode;
 //! is with in bounds.
 EventQueue *getEventQueue(uint32_t index);
 
+//! Set the scheduler used by the main event queues. Queues that already
+//! exist are switched over, keeping their pending events.
+void setMainEventQueueScheduler(const EventSchedulerFactory &factory);
+
 inline EventQueue *curEventQueue() { return _curEventQueue; }
 inline void curEventQueue(EventQueue *q);
 
@@ -251,6 +260,7 @@ class EventBase
 class Event : public EventBase, public Serializable
 {
     friend class EventQueue;
+    friend class EventBinList;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -581,6 +591,32 @@ operator!=(const Event &l, const Event &r)
     return l.when() != r.when() || l.priority() != r.priority();
 }
 
+/**
+ * One-shot event calling a callable, allocated from the EventPool and
+ * deleted once serviced or descheduled. Unlike EventFunctionWrapper, the
+ * callable is stored in place and the name is not copied, so scheduling
+ * one does not touch the heap. Use EventQueue::scheduleCallback() to
+ * create them.
+ */
+template <typename F>
+class CallbackEvent : public Event, public EventPoolAllocated
+{
+  private:
+    F callback;
+    const char *_name;
+
+  public:
+    template <typename G>
+    CallbackEvent(G &&_callback, const char *name, Priority p)
+        : Event(p, AutoDelete), callback(std::forward<G>(_callback)),
+          _name(name)
+    {}
+
+    void process() { callback(); }
+    const std::string name() const { return _name; }
+    const char *description() const { return "Callback"; }
+};
+
 /**
  * Queue of events sorted in time order
  *
@@ -628,11 +664,19 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    //! Data structure keeping the pending events. The earliest event is
+    //! cached in head.
+    std::unique_ptr<EventScheduler> scheduler;
+
+    //! Host time profile of the serviced events, if enabled.
+    std::unique_ptr<EventProfile> profile;
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! List of events added by other threads to this event queue,
+    //! along with the queue of the thread that scheduled them.
+    std::list<std::pair<Event *, EventQueue *>> async_queue;
 
     /**
      * Lock protecting event handling.
@@ -788,6 +832,25 @@ class EventQueue
             event->trace("scheduled");
     }
 
+    /**
+     * Schedule a callable to be called at the given tick, without having
+     * to manage an event. The event is pooled and deleted once serviced,
+     * which makes this the cheapest way to schedule transient actions.
+     *
+     * @param name Name of the event, which must outlive it (e.g., the
+     *             name of the scheduling object).
+     *
+     * @ingroup api_eventq
+     */
+    template <typename F>
+    void
+    scheduleCallback(F &&callback, Tick when, const char *name = "callback",
+                     Event::Priority p = Event::Default_Pri)
+    {
+        schedule(new CallbackEvent<std::decay_t<F>>(
+                    std::forward<F>(callback), name, p), when);
+    }
+
     /**
      * Deschedule the specified event. Should be called only from the owning
      * thread.
@@ -912,6 +975,17 @@ class EventQueue
      */
     void handleAsyncInsertions();
 
+    /**
+     * Ordered version of handleAsyncInsertions(). Events are merged
+     * grouped by the main event queue that scheduled them, in queue
+     * index order, so their order does not depend on how the threads
+     * interleaved. Events that would be scheduled before min_when, which
+     * has already been simulated, are delayed to it and counted.
+     *
+     * @return The number of events that had to be delayed.
+     */
+    size_t handleAsyncInsertionsOrdered(Tick min_when);
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -939,6 +1013,19 @@ class EventQueue
      */
     Event* replaceHead(Event* s);
 
+    /**
+     * Change the data structure keeping the pending events. The events
+     * currently scheduled are moved to the new scheduler, in order.
+     */
+    void setScheduler(std::unique_ptr<EventScheduler> sched);
+
+    /** Start profiling the host time spent servicing events. */
+    void enableProfile();
+
+    /** Profile of the serviced events, nullptr if not profiling. */
+    EventProfile *getProfile() { return profile.get(); }
+    const EventScheduler &getScheduler() const { return *scheduler; }
+
     /**@{*/
     /**
      * Provide an interface for locking/unlocking the event queue.
@@ -1048,6 +1135,17 @@ class EventManager
         eventq->schedule(event, when);
     }
 
+    /**
+     * @ingroup api_eventq
+     */
+    template <typename F>
+    void
+    scheduleCallback(F &&callback, Tick when, const char *name = "callback",
+                     Event::Priority p = Event::Default_Pri)
+    {
+        eventq->scheduleCallback(std::forward<F>(callback), when, name, p);
+    }
+
     /**
      * @ingroup api_eventq
      */
@@ -1112,7 +1210,7 @@ class EventWrapper : public Event
     const char *description() const { return "EventWrapped"; }
 };
 
-class EventFunctionWrapper : public Event
+class EventFunctionWrapper : public Event, public EventPoolAllocated
 {
   private:
       std::function<void(void)> callback;
@@ -0,0 +1,356 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/eventq_scheduler.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+bool
+binLess(const Event *l, const Event *r)
+{
+    return *l < *r;
+}
+
+} // anonymous namespace
+
+bool
+EventBinList::insert(Event *event)
+{
+    // Deal with the head case
+    if (!_head || *event <= *_head) {
+        _head = Event::insertBefore(event, _head);
+        return !event->nextInBin;
+    }
+
+    // Figure out either which 'in bin' list we are on, or where a new list
+    // needs to be inserted
+    Event *prev = _head;
+    Event *curr = _head->nextBin;
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    // Note: this operation may render all nextBin pointers on the
+    // prev 'in bin' list stale (except for the top one)
+    prev->nextBin = Event::insertBefore(event, curr);
+    return !event->nextInBin;
+}
+
+bool
+EventBinList::remove(Event *event)
+{
+    if (_head == NULL)
+        panic("event not found!");
+
+    // deal with an event on the head's 'in bin' list (event has the same
+    // time as the head)
+    if (*_head == *event) {
+        bool last = event == _head && !event->nextInBin;
+        _head = Event::removeItem(event, _head);
+        return last;
+    }
+
+    // Find the 'in bin' list that this event belongs on
+    Event *prev = _head;
+    Event *curr = _head->nextBin;
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    if (!curr || *curr != *event)
+        panic("event not found!");
+
+    // curr points to the top item of the the correct 'in bin' list, when
+    // we remove an item, it returns the new top item (which may be
+    // unchanged)
+    bool last = event == curr && !event->nextInBin;
+    prev->nextBin = Event::removeItem(event, curr);
+    return last;
+}
+
+bool
+EventBinList::pop()
+{
+    Event *event = _head;
+    Event *next = event->nextInBin;
+
+    if (next) {
+        // update the next bin pointer since it could be stale
+        next->nextBin = event->nextBin;
+
+        // pop the stack
+        _head = next;
+        return false;
+    } else {
+        // this was the only element on the 'in bin' list, so get rid of
+        // the 'in bin' list and point to the next bin list
+        _head = event->nextBin;
+        return true;
+    }
+}
+
+void
+EventBinList::insertBin(Event *top)
+{
+    if (!_head || *top < *_head) {
+        top->nextBin = _head;
+        _head = top;
+        return;
+    }
+
+    Event *prev = _head;
+    Event *curr = _head->nextBin;
+    while (curr && *curr < *top) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    assert(*prev != *top && (!curr || *curr != *top));
+    top->nextBin = curr;
+    prev->nextBin = top;
+}
+
+Event *
+EventBinList::popBin()
+{
+    Event *top = _head;
+    _head = top->nextBin;
+    return top;
+}
+
+void
+EventBinList::forEachBin(const std::function<void(Event *)> &f) const
+{
+    for (Event *bin = _head; bin; bin = bin->nextBin)
+        f(bin);
+}
+
+CalendarEventScheduler::CalendarEventScheduler(unsigned width_shift)
+    : buckets(MinBuckets),
+      widthShift(std::clamp(width_shift, MinWidthShift, MaxWidthShift))
+{
+}
+
+uint64_t
+CalendarEventScheduler::bucketOf(const Event *event) const
+{
+    return event->when() >> widthShift;
+}
+
+EventBinList &
+CalendarEventScheduler::listOf(uint64_t bucket)
+{
+    return buckets[bucket & (buckets.size() - 1)];
+}
+
+Event *
+CalendarEventScheduler::insert(Event *event)
+{
+    if (listOf(bucketOf(event)).insert(event))
+        numBins++;
+
+    // An event equal to the head ends up on top of the head bin, so it
+    // is serviced first.
+    if (!_head || *event <= *_head) {
+        _head = event;
+        headBucket = bucketOf(event);
+    }
+
+    if (numBins > 2 * buckets.size())
+        resize(2 * buckets.size());
+
+    return _head;
+}
+
+Event *
+CalendarEventScheduler::remove(Event *event)
+{
+    if (listOf(bucketOf(event)).remove(event))
+        numBins--;
+
+    if (event == _head)
+        findHead();
+
+    if (buckets.size() > MinBuckets && numBins < buckets.size() / 2)
+        resize(buckets.size() / 2);
+
+    return _head;
+}
+
+Event *
+CalendarEventScheduler::pop()
+{
+    assert(_head);
+
+    // The head of the queue is always the head of its own bucket.
+    if (listOf(headBucket).pop())
+        numBins--;
+
+    findHead();
+
+    if (buckets.size() > MinBuckets && numBins < buckets.size() / 2)
+        resize(buckets.size() / 2);
+
+    return _head;
+}
+
+void
+CalendarEventScheduler::findHead()
+{
+    if (numBins == 0) {
+        _head = nullptr;
+        return;
+    }
+
+    // No event can be earlier than the bucket of the previous head, so
+    // scan one year of buckets starting from there. The first bucket
+    // whose earliest event falls in the current year holds the head.
+    uint64_t bucket = headBucket;
+    for (size_t i = 0; i < buckets.size(); ++i, ++bucket) {
+        Event *event = listOf(bucket).head();
+        if (event && bucketOf(event) <= bucket) {
+            _head = event;
+            headBucket = bucket;
+            return;
+        }
+    }
+
+    // The next event is more than a year away, look for it directly.
+    Event *earliest = nullptr;
+    for (const auto &list : buckets) {
+        Event *event = list.head();
+        if (event && (!earliest || *event < *earliest))
+            earliest = event;
+    }
+    assert(earliest);
+    _head = earliest;
+    headBucket = bucketOf(earliest);
+}
+
+std::vector<Event *>
+CalendarEventScheduler::drainBins()
+{
+    std::vector<Event *> bins;
+    bins.reserve(numBins);
+    for (auto &list : buckets) {
+        while (!list.empty())
+            bins.push_back(list.popBin());
+    }
+    assert(bins.size() == numBins);
+    return bins;
+}
+
+void
+CalendarEventScheduler::resize(size_t new_size)
+{
+    std::vector<Event *> bins = drainBins();
+
+    // Size the buckets so that the earliest bins, which are the ones
+    // that will be dequeued next, are spread a few per bucket.
+    size_t samples = std::min(bins.size(), WidthSamples);
+    if (samples > 1) {
+        std::partial_sort(bins.begin(), bins.begin() + samples, bins.end(),
+                          binLess);
+        Tick span = bins[samples - 1]->when() - bins[0]->when();
+        Tick separation = span / (samples - 1);
+        if (separation >= (Tick(1) << MaxWidthShift)) {
+            widthShift = MaxWidthShift;
+        } else if (separation > 0) {
+            widthShift = std::clamp<unsigned>(ceilLog2(3 * separation),
+                                              MinWidthShift, MaxWidthShift);
+        }
+    }
+
+    buckets.assign(new_size, EventBinList());
+    for (Event *top : bins)
+        listOf(bucketOf(top)).insertBin(top);
+
+    if (_head)
+        headBucket = bucketOf(_head);
+}
+
+Event *
+CalendarEventScheduler::replaceHead(Event *s)
+{
+    // Rebuild a single sorted list from the current bins. Inserting them
+    // from the latest to the earliest always inserts at the head.
+    std::vector<Event *> bins = drainBins();
+    std::sort(bins.begin(), bins.end(), binLess);
+    EventBinList old;
+    for (auto it = bins.rbegin(); it != bins.rend(); ++it)
+        old.insertBin(*it);
+
+    numBins = 0;
+    _head = nullptr;
+
+    EventBinList incoming;
+    incoming.replace(s);
+    while (!incoming.empty()) {
+        Event *top = incoming.popBin();
+        listOf(bucketOf(top)).insertBin(top);
+        numBins++;
+        if (!_head || *top < *_head)
+            _head = top;
+    }
+
+    if (_head)
+        headBucket = bucketOf(_head);
+
+    size_t new_size = std::max<size_t>(MinBuckets, 1ULL << ceilLog2(
+                std::max<size_t>(numBins, 1)));
+    if (new_size != buckets.size())
+        resize(new_size);
+
+    return old.replace(nullptr);
+}
+
+void
+CalendarEventScheduler::forEachBin(
+        const std::function<void(Event *)> &f) const
+{
+    std::vector<Event *> bins;
+    bins.reserve(numBins);
+    for (const auto &list : buckets)
+        list.forEachBin([&bins](Event *top) { bins.push_back(top); });
+
+    std::sort(bins.begin(), bins.end(), binLess);
+    for (Event *top : bins)
+        f(top);
+}
+
+} // namespace gem5
@@ -0,0 +1,260 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Data structures that keep the pending events of an EventQueue
+ */
+
+#ifndef __SIM_EVENTQ_SCHEDULER_HH__
+#define __SIM_EVENTQ_SCHEDULER_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace gem5
+{
+
+class Event;
+
+/**
+ * Sorted list of bins, the classic gem5 event queue structure.
+ *
+ * A bin holds all the events with the same (when, priority) pair. The
+ * bins are kept in a singly linked list sorted by (when, priority)
+ * through Event::nextBin, and the events of a bin are kept in a stack
+ * through Event::nextInBin. Since the stack is accessed in LIFO order,
+ * the last event inserted into a bin is the first one to be serviced.
+ *
+ * This class only manipulates the links of the events; it is used as
+ * the building block of the EventScheduler implementations so that they
+ * all share the same ordering rules.
+ */
+class EventBinList
+{
+  private:
+    Event *_head = nullptr;
+
+  public:
+    Event *head() const { return _head; }
+    bool empty() const { return _head == nullptr; }
+
+    /**
+     * Insert an event.
+     *
+     * @return True if the event created a new bin.
+     */
+    bool insert(Event *event);
+
+    /**
+     * Remove an event, which must be in the list.
+     *
+     * @return True if the bin of the event became empty.
+     */
+    bool remove(Event *event);
+
+    /**
+     * Remove the head event.
+     *
+     * @return True if the head bin became empty.
+     */
+    bool pop();
+
+    /** Insert a full bin, preserving the order of its events. */
+    void insertBin(Event *top);
+
+    /** Remove the head bin and return its top event. */
+    Event *popBin();
+
+    /** Replace the whole list by another one and return the old one. */
+    Event *
+    replace(Event *s)
+    {
+        Event *t = _head;
+        _head = s;
+        return t;
+    }
+
+    /** Call a function with the top event of every bin, in order. */
+    void forEachBin(const std::function<void(Event *)> &f) const;
+};
+
+/**
+ * Interface of the data structure backing an EventQueue.
+ *
+ * A scheduler must service events in (when, priority) order, and events
+ * with the same (when, priority) in the reverse order of their
+ * insertion, exactly like EventBinList. Every mutator returns the new
+ * head of the queue so that the EventQueue can cache it and keep its
+ * empty()/nextTick() checks free of indirect calls.
+ */
+class EventScheduler
+{
+  public:
+    virtual ~EventScheduler() = default;
+
+    virtual const char *name() const = 0;
+
+    /** Earliest event of the queue, or nullptr if it is empty. */
+    virtual Event *head() const = 0;
+
+    /** Insert an event and return the new head. */
+    virtual Event *insert(Event *event) = 0;
+
+    /** Remove a scheduled event and return the new head. */
+    virtual Event *remove(Event *event) = 0;
+
+    /** Remove the head event and return the new head. */
+    virtual Event *pop() = 0;
+
+    /**
+     * Replace all the pending events by a bin list (as formed by
+     * EventBinList) and return the previous events in the same form.
+     */
+    virtual Event *replaceHead(Event *s) = 0;
+
+    /** Call a function with the top event of every bin, in order. */
+    virtual void forEachBin(const std::function<void(Event *)> &f) const = 0;
+};
+
+/** The default scheduler: a single sorted list of bins. */
+class ListEventScheduler : public EventScheduler
+{
+  private:
+    EventBinList bins;
+
+  public:
+    const char *name() const override { return "list"; }
+    Event *head() const override { return bins.head(); }
+
+    Event *
+    insert(Event *event) override
+    {
+        bins.insert(event);
+        return bins.head();
+    }
+
+    Event *
+    remove(Event *event) override
+    {
+        bins.remove(event);
+        return bins.head();
+    }
+
+    Event *
+    pop() override
+    {
+        bins.pop();
+        return bins.head();
+    }
+
+    Event *
+    replaceHead(Event *s) override
+    {
+        return bins.replace(s);
+    }
+
+    void
+    forEachBin(const std::function<void(Event *)> &f) const override
+    {
+        bins.forEachBin(f);
+    }
+};
+
+/**
+ * Calendar queue scheduler (R. Brown, CACM 1988).
+ *
+ * Time is divided in buckets of 2^widthShift ticks, and bins are hashed
+ * into an array of EventBinLists by their bucket number modulo the
+ * number of buckets. Finding the next event scans the array from the
+ * bucket of the current head, one "year" at a time, falling back to a
+ * direct search when a whole year is empty. The array is resized, and
+ * the bucket width recomputed from the separation of the earliest bins,
+ * whenever the number of bins drifts away from the number of buckets,
+ * which keeps insertion and removal O(1) amortized.
+ *
+ * Bins move between buckets as a whole, so the relative order of events
+ * with the same (when, priority) is identical to the list scheduler.
+ */
+class CalendarEventScheduler : public EventScheduler
+{
+  private:
+    /** Bucket array, its size is always a power of two. */
+    std::vector<EventBinList> buckets;
+
+    /** log2 of the number of ticks covered by a bucket. */
+    unsigned widthShift;
+
+    /** Number of non-empty bins. */
+    size_t numBins = 0;
+
+    /** Cached head (earliest event) of the queue. */
+    Event *_head = nullptr;
+
+    /** Absolute bucket number (when >> widthShift) of the head. */
+    uint64_t headBucket = 0;
+
+    static constexpr size_t MinBuckets = 16;
+    static constexpr unsigned MinWidthShift = 1;
+    static constexpr unsigned MaxWidthShift = 48;
+    /** Number of bins sampled to compute the bucket width. */
+    static constexpr size_t WidthSamples = 32;
+
+    uint64_t bucketOf(const Event *event) const;
+    EventBinList &listOf(uint64_t bucket);
+
+    /** Find the earliest event after removing the cached head. */
+    void findHead();
+
+    /** Rehash all the bins into a bucket array of the given size. */
+    void resize(size_t new_size);
+
+    /** Remove all bins, in no particular order. */
+    std::vector<Event *> drainBins();
+
+  public:
+    CalendarEventScheduler(unsigned width_shift = 10);
+
+    const char *name() const override { return "calendar"; }
+    Event *head() const override { return _head; }
+
+    Event *insert(Event *event) override;
+    Event *remove(Event *event) override;
+    Event *pop() override;
+    Event *replaceHead(Event *s) override;
+    void forEachBin(const std::function<void(Event *)> &f) const override;
+
+    size_t numBuckets() const { return buckets.size(); }
+    unsigned bucketWidthShift() const { return widthShift; }
+};
+
+/** Factory for the scheduler of newly created main event queues. */
+using EventSchedulerFactory = std::function<std::unique_ptr<EventScheduler>()>;
+
+} // namespace gem5
+
+#endif // __SIM_EVENTQ_SCHEDULER_HH__
@@ -0,0 +1,182 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+#include "sim/eventq_scheduler.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Event that records its id in a shared trace when processed. */
+class TraceEvent : public Event
+{
+  private:
+    int id;
+    std::vector<int> &trace;
+
+  public:
+    TraceEvent(int _id, std::vector<int> &_trace, Priority p)
+        : Event(p), id(_id), trace(_trace)
+    {}
+
+    void process() override { trace.push_back(id); }
+};
+
+/**
+ * Run the same pseudo-random sequence of schedule, deschedule,
+ * reschedule and service operations on a queue using the given
+ * scheduler, and return the order in which events were processed.
+ */
+std::vector<int>
+runSequence(std::unique_ptr<EventScheduler> sched, unsigned seed,
+            Tick spread)
+{
+    std::vector<int> trace;
+    EventQueue eq("test_eq");
+    eq.setScheduler(std::move(sched));
+
+    std::mt19937 rng(seed);
+    std::vector<std::unique_ptr<TraceEvent>> events;
+    for (int i = 0; i < 512; i++) {
+        events.push_back(std::make_unique<TraceEvent>(
+                    i, trace, (EventBase::Priority)(rng() % 3) - 1));
+    }
+
+    for (int step = 0; step < 20000; step++) {
+        TraceEvent *event = events[rng() % events.size()].get();
+        // Use a coarse grid so that many events share the same tick
+        Tick when = eq.getCurTick() + (rng() % spread) * 500;
+        switch (rng() % 4) {
+          case 0:
+          case 1:
+            if (!event->scheduled())
+                eq.schedule(event, when);
+            break;
+          case 2:
+            if (event->scheduled())
+                eq.deschedule(event);
+            else
+                eq.reschedule(event, when, true);
+            break;
+          case 3:
+            if (!eq.empty())
+                eq.serviceOne();
+            break;
+        }
+        if (step % 64 == 0)
+            EXPECT_TRUE(eq.debugVerify());
+    }
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    return trace;
+}
+
+} // anonymous namespace
+
+/** The calendar scheduler must service events exactly like the list. */
+TEST(EventQueueSchedulerTest, CalendarMatchesList)
+{
+    for (unsigned seed = 0; seed < 4; seed++) {
+        for (Tick spread : {Tick(1), Tick(8), Tick(1000), Tick(1) << 30}) {
+            auto expected = runSequence(
+                    std::make_unique<ListEventScheduler>(), seed, spread);
+            auto actual = runSequence(
+                    std::make_unique<CalendarEventScheduler>(), seed, spread);
+            ASSERT_FALSE(expected.empty());
+            ASSERT_EQ(expected, actual);
+        }
+    }
+}
+
+/** Events of the same bin are serviced in LIFO order. */
+TEST(EventQueueSchedulerTest, SameBinOrder)
+{
+    std::vector<int> trace;
+    EventQueue eq("test_eq");
+    eq.setScheduler(std::make_unique<CalendarEventScheduler>());
+
+    TraceEvent e0(0, trace, Event::Default_Pri);
+    TraceEvent e1(1, trace, Event::Default_Pri);
+    TraceEvent e2(2, trace, Event::Default_Pri);
+    TraceEvent e3(3, trace, Event::CPU_Tick_Pri);
+    eq.schedule(&e3, 100);
+    eq.schedule(&e0, 100);
+    eq.schedule(&e1, 100);
+    eq.schedule(&e2, 100);
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(trace, std::vector<int>({2, 1, 0, 3}));
+}
+
+/** Switching scheduler keeps pending events and their order. */
+TEST(EventQueueSchedulerTest, SwitchScheduler)
+{
+    std::vector<int> trace;
+    EventQueue eq("test_eq");
+
+    std::vector<std::unique_ptr<TraceEvent>> events;
+    for (int i = 0; i < 200; i++) {
+        events.push_back(std::make_unique<TraceEvent>(
+                    i, trace, Event::Default_Pri));
+        eq.schedule(events.back().get(), (i % 17) * 1000 + (i % 3));
+    }
+
+    eq.setScheduler(std::make_unique<CalendarEventScheduler>());
+    EXPECT_STREQ(eq.getScheduler().name(), "calendar");
+    EXPECT_TRUE(eq.debugVerify());
+
+    // Temporarily swap the events out, as Ruby does for cache warmup
+    Event *saved = eq.replaceHead(nullptr);
+    EXPECT_TRUE(eq.empty());
+    eq.replaceHead(saved);
+
+    eq.setScheduler(std::make_unique<ListEventScheduler>());
+    std::vector<int> expected;
+    for (Tick t = 0; t < 17; t++) {
+        for (Tick r = 0; r < 3; r++) {
+            for (int i = 199; i >= 0; i--) {
+                if (i % 17 == t && i % 3 == r)
+                    expected.push_back(i);
+            }
+        }
+    }
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(trace, expected);
+}
@@ -29,22 +29,32 @@
 
 #include "sim/global_event.hh"
 
+#include <algorithm>
+
 #include "sim/cur_tick.hh"
 
 namespace gem5
 {
 
 std::mutex BaseGlobalEvent::globalQMutex;
+std::set<BaseGlobalEvent *> BaseGlobalEvent::globalEvents;
 
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
     : barrier(numMainEventQueues),
       barrierEvent(numMainEventQueues, NULL)
 {
+    std::lock_guard<std::mutex> lock(globalQMutex);
+    globalEvents.insert(this);
 }
 
 
 BaseGlobalEvent::~BaseGlobalEvent()
 {
+    {
+        std::lock_guard<std::mutex> lock(globalQMutex);
+        globalEvents.erase(this);
+    }
+
     // see GlobalEvent::BarrierEvent::~BarrierEvent() comments
     if (barrierEvent[0] != NULL) {
         for (int i = 0; i < numMainEventQueues; ++i)
@@ -112,6 +122,20 @@ void BaseGlobalEvent::reschedule(Tick when)
     globalQMutex.unlock();
 }
 
+Tick
+BaseGlobalEvent::earliestScheduled()
+{
+    std::lock_guard<std::mutex> lock(globalQMutex);
+
+    Tick when = MaxTick;
+    for (auto *event : globalEvents) {
+        // Slot 0 is cleared while an auto-deleted event is destroyed
+        if (event->barrierEvent[0] && event->scheduled())
+            when = std::min(when, event->when());
+    }
+    return when;
+}
+
 BaseGlobalEvent::BarrierEvent::~BarrierEvent()
 {
     // if AutoDelete is set, local events will get deleted in event
@@ -31,6 +31,7 @@
 #define __SIM_GLOBAL_EVENT_HH__
 
 #include <mutex>
+#include <set>
 #include <vector>
 
 #include "base/barrier.hh"
@@ -70,6 +71,9 @@ class BaseGlobalEvent : public EventBase
       //! which can result in a deadlock.
       static std::mutex globalQMutex;
 
+      //! All the global events in existence, protected by globalQMutex.
+      static std::set<BaseGlobalEvent *> globalEvents;
+
   protected:
 
     /// The base class for the local events that will synchronize
@@ -144,6 +148,13 @@ class BaseGlobalEvent : public EventBase
 
     void deschedule();
     void reschedule(Tick when);
+
+    /**
+     * Time of the earliest scheduled global event, or MaxTick if there
+     * is none. This must only be called while no event queue is being
+     * serviced, e.g. between two synchronization barriers.
+     */
+    static Tick earliestScheduled();
 };
 
 
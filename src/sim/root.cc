@@ -41,13 +41,19 @@
 
 #include "base/hostinfo.hh"
 #include "base/logging.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
+#include "enums/EventQueueScheduler.hh"
+#include "enums/EventQueueSync.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
+#include "sim/event_profile.hh"
 #include "sim/eventq.hh"
 #include "sim/full_system.hh"
 #include "sim/root.hh"
+#include "sim/simulate.hh"
 
 namespace gem5
 {
@@ -175,6 +181,21 @@ Root::timeSyncSpinThreshold(Time newThreshold)
     timeSyncEnable(en);
 }
 
+/** Write the event profile along with the statistics. */
+static void
+writeEventProfile()
+{
+    EventProfile profile = mainEventProfile();
+
+    OutputStream *report = simout.create("event_profile.txt");
+    profile.dump(*report->stream());
+    simout.close(report);
+
+    OutputStream *folded = simout.create("event_profile.folded");
+    profile.dumpFolded(*folded->stream());
+    simout.close(folded);
+}
+
 Root::Root(const RootParams &p, int)
     : SimObject(p), _enabled(false), _periodTick(p.time_sync_period),
       syncEvent([this]{ timeSync(); }, name())
@@ -188,6 +209,28 @@ Root::Root(const RootParams &p, int)
 
     simQuantum = p.sim_quantum;
 
+    switch (p.eventq_scheduler) {
+      case EventQueueScheduler::list:
+        break;
+      case EventQueueScheduler::calendar:
+        setMainEventQueueScheduler([]() {
+            return std::make_unique<CalendarEventScheduler>();
+        });
+        break;
+      default:
+        panic("Unknown event queue scheduler.\n");
+    }
+
+    if (p.eventq_sync == EventQueueSync::conservative)
+        setEventQueueLookahead(p.eventq_lookahead);
+
+    if (p.event_profile) {
+        enableEventProfile();
+        statistics::registerDumpCallback(writeEventProfile);
+        statistics::registerResetCallback(resetEventProfile);
+        registerExitCallback(writeEventProfile);
+    }
+
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
     // having a single global stat group for global stats. Merge that
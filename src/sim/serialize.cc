@@ -100,6 +100,13 @@ Serializable::generateCheckpointOut(const std::string &cpt_dir,
     outstream << "## checkpoint generated: " << ctime(&t);
 }
 
+CallbackQueue &
+Serializable::postCheckpointCallbacks()
+{
+    static CallbackQueue callbacks;
+    return callbacks;
+}
+
 Serializable::ScopedCheckpointSection::~ScopedCheckpointSection()
 {
     assert(!path.empty());
@@ -156,6 +163,13 @@ CheckpointIn::dir()
     return currentDirectory;
 }
 
+bool
+CheckpointIn::writeIndex(const std::string &cpt_dir)
+{
+    return MappedIniFile::writeIndex(
+            cpt_dir + "/" + CheckpointIn::baseFilename);
+}
+
 CheckpointIn::CheckpointIn(const std::string &cpt_dir)
     : db(), _cptDir(setDir(cpt_dir))
 {
@@ -56,8 +56,10 @@
 #include <unordered_map>
 #include <vector>
 
+#include "base/callback.hh"
 #include "base/inifile.hh"
 #include "base/logging.hh"
+#include "base/mapped_inifile.hh"
 #include "sim/serialize_handlers.hh"
 
 namespace gem5
@@ -68,7 +70,7 @@ typedef std::ostream CheckpointOut;
 class CheckpointIn
 {
   private:
-    IniFile db;
+    MappedIniFile db;
 
     const std::string _cptDir;
 
@@ -128,6 +130,14 @@ class CheckpointIn
      */
     static std::string dir();
 
+    /**
+     * Write the binary index of the checkpoint file of a directory (see
+     * MappedIniFile), which makes restoring the checkpoint faster.
+     *
+     * @return False if the index couldn't be written.
+     */
+    static bool writeIndex(const std::string &cpt_dir);
+
     // Filename for base checkpoint file within directory.
     static const char *baseFilename;
 };
@@ -311,6 +321,15 @@ class Serializable
     static void generateCheckpointOut(const std::string &cpt_dir,
         std::ofstream &outstream);
 
+    /**
+     * Callbacks called once all the objects have been serialized, for
+     * state shared by several objects (e.g. the host dirty page tracking
+     * of the physical memories, which covers the whole process).
+     *
+     * @ingroup api_serialize
+     */
+    static CallbackQueue &postCheckpointCallbacks();
+
   private:
     static std::stack<std::string> path;
 };
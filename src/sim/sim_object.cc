@@ -146,6 +146,8 @@ SimObject::serializeAll(const std::string &cpt_dir)
         // since we are at the top level.
         obj->serializeSection(cp, obj->name());
    }
+
+    Serializable::postCheckpointCallbacks().process();
 }
 
 #ifdef DEBUG
@@ -42,15 +42,19 @@
 
 #include "sim/simulate.hh"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <thread>
 
+#include "base/barrier.hh"
 #include "base/logging.hh"
 #include "base/pollevent.hh"
 #include "base/types.hh"
 #include "sim/async.hh"
+#include "sim/core.hh"
 #include "sim/eventq.hh"
+#include "sim/global_event.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stat_control.hh"
@@ -63,6 +67,158 @@ Event *doSimLoop(EventQueue *);
 
 GlobalSimLoopExitEvent *simulate_limit_event = nullptr;
 
+static std::vector<Tick> eventqLookahead;
+
+/**
+ * Conservative synchronization of the main event queues.
+ *
+ * Rather than synchronizing every simQuantum ticks, the queues advance
+ * in windows derived from the lookahead between them. When a window
+ * starts, queue j cannot produce anything before the tick T_j of its
+ * next event, so nothing can reach queue i before T_j + L[j][i], where
+ * L[j][i] is the minimum latency of the links from queue j to queue
+ * i. Queue i can therefore process all its events before the minimum of
+ * these bounds without waiting for the others.
+ *
+ * Events scheduled across queues are only merged at window boundaries,
+ * in source queue order, so their order in the target queue doesn't
+ * depend on the host. This doesn't make the simulation deterministic:
+ * a timing request still calls into the receiver on the sender's host
+ * thread, so objects shared across queues may see the accesses of the
+ * queues in any order. Windows are also kept within simQuantum of the
+ * earliest queue, which bounds how far ahead global events scheduled
+ * from a thread have to be.
+ */
+class ConservativeSync
+{
+  private:
+    uint32_t numQueues;
+    std::vector<Tick> lookahead;
+    Barrier barrier;
+
+    //! Next event of each queue at the start of the current window
+    std::vector<Tick> nextTick;
+    //! End (exclusive) of the current window of each queue
+    std::vector<Tick> windowEnd;
+
+    static Tick
+    addTicks(Tick a, Tick b)
+    {
+        return a > MaxTick - b ? MaxTick : a + b;
+    }
+
+  public:
+    ConservativeSync(uint32_t num_queues, const std::vector<Tick> &_lookahead)
+        : numQueues(num_queues), lookahead(_lookahead), barrier(num_queues),
+          nextTick(num_queues, 0), windowEnd(num_queues, 0)
+    {
+        fatal_if(lookahead.size() != numQueues * numQueues,
+                 "Lookahead matrix has %d entries, %d event queues need %d.",
+                 lookahead.size(), numQueues, numQueues * numQueues);
+
+        Tick max_lookahead = 0;
+        for (uint32_t src = 0; src < numQueues; src++) {
+            for (uint32_t dst = 0; dst < numQueues; dst++) {
+                Tick l = lookahead[src * numQueues + dst];
+                if (src == dst || l == MaxTick)
+                    continue;
+                fatal_if(l == 0, "Event queues %d and %d are connected with "
+                         "no latency, conservative synchronization needs "
+                         "a lookahead.", src, dst);
+                max_lookahead = std::max(max_lookahead, l);
+            }
+        }
+
+        // Global events scheduled from a thread are delayed by
+        // simQuantum, which must cover the longest window. Queues that
+        // aren't connected at all still meet every microsecond, as
+        // exitSimLoop() and the stat events are delayed by simQuantum.
+        if (simQuantum == 0) {
+            simQuantum = max_lookahead ? max_lookahead :
+                sim_clock::as_int::us;
+        }
+    }
+
+    /**
+     * Merge the events other queues scheduled in a queue. Everything
+     * before the end of the previous window of the queue has been
+     * simulated, so an event scheduled before it means the lookahead was
+     * wrong and the results can't be trusted.
+     */
+    void
+    mergeAsyncInsertions(uint32_t index)
+    {
+        EventQueue *eventq = mainEventQueue[index];
+        size_t late = eventq->handleAsyncInsertionsOrdered(windowEnd[index]);
+        fatal_if(late, "%d cross event queue events were scheduled in "
+                 "event queue %d before tick %d, which it had already "
+                 "simulated. The lookahead between the event queues is "
+                 "too optimistic.", late, index, windowEnd[index]);
+    }
+
+    /**
+     * Wait for all queues to finish their window and start the next one.
+     *
+     * @return The end (exclusive) of the new window of the queue.
+     */
+    Tick
+    nextWindow(uint32_t index)
+    {
+        EventQueue *eventq = mainEventQueue[index];
+
+        barrier.wait();
+
+        mergeAsyncInsertions(index);
+        nextTick[index] = eventq->nextTick();
+
+        barrier.wait();
+
+        // All the queues compute all the windows from the same data, so
+        // they agree on them without an extra barrier.
+        Tick earliest = *std::min_element(nextTick.begin(), nextTick.end());
+        Tick limit = addTicks(earliest, simQuantum);
+        std::vector<Tick> ends(numQueues, limit);
+        for (uint32_t dst = 0; dst < numQueues; dst++) {
+            for (uint32_t src = 0; src < numQueues; src++) {
+                Tick l = lookahead[src * numQueues + dst];
+                if (src != dst && l != MaxTick) {
+                    ends[dst] = std::min(ends[dst],
+                                         addTicks(nextTick[src], l));
+                }
+            }
+        }
+
+        // Global events synchronize all the queues, either all the
+        // windows include the next one or none of them does.
+        Tick global = BaseGlobalEvent::earliestScheduled();
+        if (*std::min_element(ends.begin(), ends.end()) <= global) {
+            for (auto &end : ends)
+                end = std::min(end, global);
+        }
+
+        windowEnd[index] = ends[index];
+        return ends[index];
+    }
+
+    /**
+     * Leave the current window early to return to Python, the queue has
+     * not simulated past its current tick.
+     */
+    void
+    leaveWindow(uint32_t index)
+    {
+        windowEnd[index] = mainEventQueue[index]->getCurTick();
+    }
+};
+
+static std::unique_ptr<ConservativeSync> conservativeSync;
+
+void
+setEventQueueLookahead(const std::vector<Tick> &lookahead)
+{
+    eventqLookahead = lookahead;
+}
+
 class SimulatorThreads
 {
   public:
@@ -203,7 +359,14 @@ simulate(Tick num_cycles)
     }
     simulate_limit_event->reschedule(exit_tick);
 
-    if (numMainEventQueues > 1) {
+    if (numMainEventQueues > 1 && !eventqLookahead.empty()) {
+        if (!conservativeSync) {
+            conservativeSync.reset(new ConservativeSync(numMainEventQueues,
+                                                        eventqLookahead));
+        }
+
+        inParallelMode = true;
+    } else if (numMainEventQueues > 1) {
         fatal_if(simQuantum == 0,
                  "Quantum for multi-eventq simulation not specified");
 
@@ -270,9 +433,31 @@ doSimLoop(EventQueue *eventq)
 {
     // set the per thread current eventq pointer
     curEventQueue(eventq);
-    eventq->handleAsyncInsertions();
+
+    // With conservative synchronization, events are only serviced up to
+    // the end of the current window of the queue.
+    const bool conservative = conservativeSync && inParallelMode;
+    uint32_t index = 0;
+    Tick window_end = MaxTick;
+    if (conservative) {
+        index = std::find(mainEventQueue.begin(), mainEventQueue.end(),
+                          eventq) - mainEventQueue.begin();
+        window_end = 0;
+        // Events left over from the previous window are merged in the
+        // same order, and with the same bound, as at a window boundary.
+        conservativeSync->mergeAsyncInsertions(index);
+    } else {
+        eventq->handleAsyncInsertions();
+    }
 
     while (1) {
+        // A window ending at MaxTick includes it, so that the events at
+        // MaxTick (e.g. the default simulate() limit) are serviced.
+        while (conservative && window_end != MaxTick &&
+               eventq->nextTick() >= window_end) {
+            window_end = conservativeSync->nextWindow(index);
+        }
+
         // there should always be at least one event (the SimLoopExitEvent
         // we just scheduled) in the queue
         assert(!eventq->empty());
@@ -307,6 +492,8 @@ doSimLoop(EventQueue *eventq)
 
         Event *exit_event = eventq->serviceOne();
         if (exit_event != NULL) {
+            if (conservative)
+                conservativeSync->leaveWindow(index);
             return exit_event;
         }
     }
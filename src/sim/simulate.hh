@@ -38,6 +38,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <vector>
+
 #include "base/types.hh"
 
 namespace gem5
@@ -57,4 +59,15 @@ void terminateEventQueueThreads();
 
 extern GlobalSimLoopExitEvent *simulate_limit_event;
 
+/**
+ * Synchronize the main event queues conservatively, using lookahead
+ * windows instead of a fixed simulation quantum.
+ *
+ * @param lookahead Minimum latency of the links from each main event
+ * queue to each other, as a matrix flattened in source major order.
+ * MaxTick marks queues that do not communicate. An empty matrix selects
+ * the quantum-based synchronization.
+ */
+void setEventQueueLookahead(const std::vector<Tick> &lookahead);
+
 } // namespace gem5
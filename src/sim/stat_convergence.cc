@@ -0,0 +1,119 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stat_convergence.hh"
+
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "base/trace.hh"
+#include "debug/StatConvergence.hh"
+#include "sim/cur_tick.hh"
+#include "sim/root.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+const std::string StatConvergence::ExitCause = "stats converged";
+
+StatConvergence::StatConvergence(const StatConvergenceParams &p)
+    : SimObject(p), interval(p.interval),
+      sampleEvent([this]{ sample(); }, name())
+{
+    fatal_if(p.stats.empty(), "%s: No stats to monitor.", name());
+    fatal_if(interval == 0, "%s: The sampling interval can't be 0.",
+             name());
+    fatal_if(p.window < 2, "%s: The window needs at least 2 samples.",
+             name());
+
+    for (const auto &stat : p.stats) {
+        monitors.push_back({stat, nullptr,
+                statistics::ConvergenceWindow(p.window, p.tolerance)});
+    }
+
+    statistics::registerResetCallback([this]() {
+        for (auto &monitor : monitors)
+            monitor.window.clear();
+        // Start over if the stats already converged.
+        if (converged) {
+            converged = false;
+            schedule(sampleEvent, curTick() + interval);
+        }
+    });
+}
+
+void
+StatConvergence::startup()
+{
+    // The stat hierarchy is only complete once all the objects have
+    // registered their stats.
+    for (auto &monitor : monitors) {
+        monitor.info = Root::root()->resolveStat(monitor.name);
+        fatal_if(!monitor.info, "%s: Can't find stat %s.", name(),
+                 monitor.name);
+        fatal_if(!dynamic_cast<const statistics::ScalarInfo *>(
+                     monitor.info) &&
+                 !dynamic_cast<const statistics::VectorInfo *>(monitor.info),
+                 "%s: Stat %s isn't a scalar, vector or formula.", name(),
+                 monitor.name);
+    }
+
+    schedule(sampleEvent, curTick() + interval);
+}
+
+double
+StatConvergence::value(const statistics::Info &info)
+{
+    if (auto scalar = dynamic_cast<const statistics::ScalarInfo *>(&info))
+        return scalar->result();
+    return dynamic_cast<const statistics::VectorInfo &>(info).total();
+}
+
+void
+StatConvergence::sample()
+{
+    bool all_converged = true;
+    for (auto &monitor : monitors) {
+        double v = value(*monitor.info);
+        monitor.window.sample(v);
+        DPRINTF(StatConvergence, "%s = %f, spread %f over %d samples\n",
+                monitor.name, v, monitor.window.spread(),
+                monitor.window.numSamples());
+        all_converged = all_converged && monitor.window.converged();
+    }
+
+    if (all_converged) {
+        // Only exit once; the windows would keep converging every
+        // interval if the simulation goes on.
+        inform("%s: Stats converged at tick %d.", name(), curTick());
+        converged = true;
+        exitSimLoop(ExitCause);
+        return;
+    }
+
+    schedule(sampleEvent, curTick() + interval);
+}
+
+} // namespace gem5
@@ -0,0 +1,87 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_STAT_CONVERGENCE_HH__
+#define __SIM_STAT_CONVERGENCE_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/stats/convergence.hh"
+#include "base/stats/info.hh"
+#include "params/StatConvergence.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+/**
+ * Stops the simulation once a set of stats has converged.
+ *
+ * The value of each monitored stat is sampled every interval, without
+ * dumping the stats, and kept in a statistics::ConvergenceWindow. Once
+ * the windows of all the stats have converged, the simulation loop is
+ * exited with the cause "stats converged" and the sampling stops.
+ * Resetting the stats restarts the windows, and the sampling if it had
+ * stopped.
+ */
+class StatConvergence : public SimObject
+{
+  private:
+    /** A monitored stat. */
+    struct Monitor
+    {
+        std::string name;
+        const statistics::Info *info;
+        statistics::ConvergenceWindow window;
+    };
+
+    std::vector<Monitor> monitors;
+
+    const Tick interval;
+
+    EventFunctionWrapper sampleEvent;
+
+    /** Whether the stats converged since they were last reset. */
+    bool converged = false;
+
+    /** Read the current value of a scalar, vector or formula stat. */
+    static double value(const statistics::Info &info);
+
+    void sample();
+
+  public:
+    /** Exit cause of the simulation loop once the stats converged. */
+    static const std::string ExitCause;
+
+    StatConvergence(const StatConvergenceParams &p);
+
+    void startup() override;
+};
+
+} // namespace gem5
+
+#endif // __SIM_STAT_CONVERGENCE_HH__
@@ -182,7 +182,9 @@ System::System(const Params &p)
       physProxy(_systemPort, p.cache_line_size),
       workload(p.workload),
       physmem(name() + ".physmem", p.memories, p.mmap_using_noreserve,
-              p.shared_backstore, p.auto_unlink_shared_backstore),
+              p.shared_backstore, p.auto_unlink_shared_backstore,
+              p.memory_checkpoint_format,
+              p.memory_checkpoint_max_deltas),
       ShadowRomRanges(p.shadow_rom_ranges.begin(),
                       p.shadow_rom_ranges.end()),
       memoryMode(p.mem_mode),
@@ -289,6 +291,24 @@ System::replaceThreadContext(ThreadContext *tc, ContextID context_id)
     }
 }
 
+void
+System::registerMemWriteListener(BaseCPU *cpu)
+{
+    if (std::find(memWriteListeners.begin(), memWriteListeners.end(),
+                  cpu) == memWriteListeners.end()) {
+        memWriteListeners.push_back(cpu);
+    }
+}
+
+void
+System::notifyMemWriteListeners(PacketPtr pkt, const BaseCPU *source) const
+{
+    for (auto *cpu : memWriteListeners) {
+        if (cpu != source)
+            cpu->unsnoopedWrite(pkt);
+    }
+}
+
 Addr
 System::memSize() const
 {
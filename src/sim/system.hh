@@ -68,6 +68,7 @@
 namespace gem5
 {
 
+class BaseCPU;
 class BaseRemoteGDB;
 class KvmVM;
 class ThreadContext;
@@ -581,6 +582,30 @@ class System : public SimObject, public PCEventScope
     void registerThreadContext(ThreadContext *tc);
     void replaceThreadContext(ThreadContext *tc, ContextID context_id);
 
+    /**
+     * Register a CPU which keeps state derived from the memory contents
+     * (e.g. decoded instructions), and so has to hear about every write
+     * to memory, snooped or not.
+     */
+    void registerMemWriteListener(BaseCPU *cpu);
+
+    /**
+     * Tell the listening CPUs, except the one doing it, about a write to
+     * memory. The memories call this for the writes they perform, the
+     * CPUs for the ones they do through a backdoor.
+     */
+    void
+    notifyMemWrite(PacketPtr pkt, const BaseCPU *source=nullptr) const
+    {
+        if (!memWriteListeners.empty())
+            notifyMemWriteListeners(pkt, source);
+    }
+
+  private:
+    std::vector<BaseCPU *> memWriteListeners;
+
+    void notifyMemWriteListeners(PacketPtr pkt, const BaseCPU *source) const;
+
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
@@ -0,0 +1,119 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Runs a binary on two identical O3 systems at once, one using the List
+IQ scheduler and the other the Matrix one, and checks that the two
+schedulers produce the same statistics.
+"""
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.stats.gem5stats import get_simstat
+
+parser = argparse.ArgumentParser()
+parser.add_argument('binary', type = str)
+
+args = parser.parse_args()
+
+def build_system(scheduler):
+    system = System()
+
+    system.workload = SEWorkload.init_compatible(args.binary)
+
+    system.clk_domain = SrcClockDomain()
+    system.clk_domain.clock = '1GHz'
+    system.clk_domain.voltage_domain = VoltageDomain()
+    system.mem_mode = 'timing'
+    system.mem_ranges = [AddrRange('512MB')]
+
+    system.cpu = DerivO3CPU(iqScheduler = scheduler)
+    system.cpu.icache = Cache(size = '32kB', assoc = 8, tag_latency = 1,
+                              data_latency = 1, response_latency = 1,
+                              mshrs = 16, tgts_per_mshr = 20)
+    system.cpu.dcache = Cache(size = '32kB', assoc = 8, tag_latency = 1,
+                              data_latency = 1, response_latency = 1,
+                              mshrs = 16, tgts_per_mshr = 20)
+    system.membus = SystemXBar()
+    system.cpu.icache.cpu_side = system.cpu.icache_port
+    system.cpu.dcache.cpu_side = system.cpu.dcache_port
+    system.cpu.icache.mem_side = system.membus.cpu_side_ports
+    system.cpu.dcache.mem_side = system.membus.cpu_side_ports
+
+    system.cpu.createInterruptController()
+    if m5.defines.buildEnv['TARGET_ISA'] == "x86":
+        system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+        system.cpu.interrupts[0].int_master = system.membus.cpu_side_ports
+        system.cpu.interrupts[0].int_slave = system.membus.mem_side_ports
+
+    system.mem_ctrl = SimpleMemory(latency = '1ns')
+    system.mem_ctrl.range = system.mem_ranges[0]
+    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.system_port = system.membus.cpu_side_ports
+
+    process = Process()
+    process.cmd = [args.binary]
+    system.cpu.workload = process
+    system.cpu.createThreads()
+
+    return system
+
+root = Root(full_system = False)
+root.list_system = build_system('List')
+root.matrix_system = build_system('Matrix')
+m5.instantiate()
+
+# The simulation loop exits once the processes of both systems are done.
+exit_event = m5.simulate()
+if exit_event.getCause() != 'exiting with last active thread context':
+    sys.exit(1)
+
+stats = {
+    system.get_name(): get_simstat([system]).to_json()[system.get_name()]
+    for system in (root.list_system, root.matrix_system)
+}
+
+def flatten(prefix, value, out):
+    if isinstance(value, dict):
+        for key, child in value.items():
+            flatten(f"{prefix}.{key}", child, out)
+    else:
+        out[prefix] = value
+    return out
+
+list_stats = flatten("", stats["list_system"], {})
+matrix_stats = flatten("", stats["matrix_system"], {})
+mismatches = sorted(
+    name for name in list_stats.keys() | matrix_stats.keys()
+    if list_stats.get(name) != matrix_stats.get(name)
+)
+for name in mismatches:
+    print(f"Stat mismatch: {name}: List {list_stats.get(name)}, "
+          f"Matrix {matrix_stats.get(name)}")
+if mismatches:
+    sys.exit(1)
+
+print("The List and Matrix IQ schedulers produced the same stats.")
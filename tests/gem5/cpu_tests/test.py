@@ -86,3 +86,21 @@ for isa in valid_isas:
                   valid_isas=(isa,),
                   fixtures=[workload_binary]
             )
+
+# The Matrix IQ scheduler has to issue exactly like the List one.
+for isa in valid_isas:
+    path = joinpath(base_path, isa.lower())
+    workload = 'Bubblesort'
+    url = isa_url[isa] + '/' + workload
+    workload_binary = DownloadedProgram(url, path, workload)
+    binary = joinpath(workload_binary.path, workload)
+
+    gem5_verify_config(
+          name='cpu_test_iq_schedulers_{}'.format(workload),
+          verifiers=(verifier.MatchRegex(
+              'The List and Matrix IQ schedulers produced the same stats'),),
+          config=joinpath(getcwd(), 'run_iq_schedulers.py'),
+          config_args=[binary],
+          valid_isas=(isa,),
+          fixtures=[workload_binary]
+    )
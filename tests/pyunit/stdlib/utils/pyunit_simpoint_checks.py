@@ -0,0 +1,146 @@
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import gzip
+import os
+import tempfile
+import unittest
+
+from gem5.utils.simpoint import (
+    read_bbv,
+    read_simpoints,
+    read_stats,
+    reweight_stats,
+    select_simpoints,
+    write_simpoints,
+)
+
+
+class SimPointSelectionTestSuite(unittest.TestCase):
+    """Test cases for the SimPoint selection of gem5.utils.simpoint"""
+
+    def _write_bbv(self, bbvs) -> str:
+        file = tempfile.NamedTemporaryFile(suffix=".bb.gz", delete=False)
+        file.close()
+        with gzip.open(file.name, "wt") as f:
+            for bbv in bbvs:
+                f.write(
+                    "T"
+                    + "".join(f":{bb}:{count} " for bb, count in bbv.items())
+                    + "\n"
+                )
+        return file.name
+
+    def test_readBbv(self) -> None:
+        path = self._write_bbv([{1: 10, 2: 20}, {3: 30}])
+        self.assertEqual(read_bbv(path), [{1: 10, 2: 20}, {3: 30}])
+        os.remove(path)
+
+    def test_twoPhases(self) -> None:
+        # Two clearly distinct phases must give two SimPoints, one in each
+        # phase, weighted by the length of the phase.
+        bbvs = [{1: 900 + i, 2: 100} for i in range(30)]
+        bbvs += [{3: 500, 4: 500 + i} for i in range(10)]
+        simpoints = select_simpoints(bbvs, max_k=5)
+
+        self.assertEqual(len(simpoints), 2)
+        self.assertLess(simpoints[0][0], 30)
+        self.assertGreaterEqual(simpoints[1][0], 30)
+        self.assertAlmostEqual(simpoints[0][1], 0.75)
+        self.assertAlmostEqual(simpoints[1][1], 0.25)
+
+    def test_simpointFiles(self) -> None:
+        simpoints = [(3, 0.5), (10, 0.25), (42, 0.25)]
+        directory = tempfile.mkdtemp()
+        simpts = os.path.join(directory, "simpoints.simpts")
+        weights = os.path.join(directory, "simpoints.weights")
+        write_simpoints(simpoints, simpts, weights)
+        self.assertEqual(read_simpoints(simpts, weights), simpoints)
+
+
+class StatsReweightTestSuite(unittest.TestCase):
+    """Test cases for gem5.utils.simpoint.reweight_stats()"""
+
+    def _write_stats(self, lines) -> str:
+        file = tempfile.NamedTemporaryFile(mode="w", delete=False)
+        file.write("\n---------- Begin Simulation Statistics ----------\n")
+        for line in lines:
+            file.write(line + "\n")
+        file.write("\n---------- End Simulation Statistics   ----------\n")
+        file.close()
+        return file.name
+
+    def test_weightedAverage(self) -> None:
+        # Both regions have 1000 instructions.
+        first = self._write_stats(
+            [
+                "system.cpu.numCycles 2000 # Cycles ((Cycle))",
+                "system.cpu.ipc 0.500000 # IPC ((Count/Cycle))",
+                "system.cpu.cpi 2.000000 # CPI ((Cycle/Count))",
+                "system.cpu.only 5 # Only in the first region",
+            ]
+        )
+        second = self._write_stats(
+            [
+                "system.cpu.numCycles 1000 # Cycles ((Cycle))",
+                "system.cpu.ipc 1.000000 # IPC ((Count/Cycle))",
+                "system.cpu.cpi 1.000000 # CPI ((Cycle/Count))",
+            ]
+        )
+        output = tempfile.NamedTemporaryFile(delete=False)
+        output.close()
+        reweight_stats([(first, 3), (second, 1)], output.name)
+
+        stats = {
+            name: (values, desc)
+            for name, values, desc in read_stats(output.name)
+        }
+        self.assertEqual(stats["system.cpu.numCycles"][0], ["1750"])
+        # 1000 instructions in 1750 cycles, i.e., 1 / CPI.
+        self.assertEqual(stats["system.cpu.ipc"][0], ["0.571429"])
+        self.assertEqual(stats["system.cpu.cpi"][0], ["1.750000"])
+        self.assertEqual(stats["system.cpu.ipc"][1], "IPC ((Count/Cycle))")
+        self.assertEqual(stats["system.cpu.only"][0], ["3.750000"])
+
+        for path in (first, second, output.name):
+            os.remove(path)
+
+    def test_rateWithoutDenominator(self) -> None:
+        first = self._write_stats(
+            ["system.mem.bw 2.000000 # BW ((Byte/Cycle))"]
+        )
+        second = self._write_stats(
+            ["system.mem.bw 4.000000 # BW ((Byte/Cycle))"]
+        )
+        output = tempfile.NamedTemporaryFile(delete=False)
+        output.close()
+        reweight_stats([(first, 1), (second, 1)], output.name)
+
+        stats = {name: values for name, values, _ in read_stats(output.name)}
+        self.assertEqual(stats["system.mem.bw"], ["3.000000"])
+
+        for path in (first, second, output.name):
+            os.remove(path)
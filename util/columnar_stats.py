@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2022 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Reader of the binary columnar stats files written by the "columnar://"
+stats output of gem5 (see src/base/stats/columnar.hh for the format).
+
+As a module:
+
+    from columnar_stats import ColumnarStats
+
+    stats = ColumnarStats("m5out/stats.cst")
+    ticks = stats.ticks                       # (dumps,)
+    ipc = stats["system.cpu.ipc"]             # (dumps,)
+    misses = stats["system.cpu.dcache.demandMisses"]  # (dumps, n)
+
+Dumps that do not contain a stat (e.g., dumps of another part of the
+hierarchy) hold NaN for it.
+
+As a script, prints the names of the stats, or some stats as CSV:
+
+    columnar_stats.py m5out/stats.cst
+    columnar_stats.py m5out/stats.cst system.cpu.ipc system.cpu.numCycles
+"""
+
+import argparse
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"gem5cst\0"
+VERSION = 1
+SCHEMA_RECORD = 1
+ROW_RECORD = 2
+
+KINDS = ["scalar", "vector", "vector2d", "formula", "dist", "vector_dist"]
+
+
+class StatInfo:
+    def __init__(self, kind, size, name, desc, unit, subnames):
+        self.kind = KINDS[kind] if kind < len(KINDS) else kind
+        self.size = size
+        self.name = name
+        self.desc = desc
+        self.unit = unit
+        self.subnames = subnames
+
+
+class ColumnarStats:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:8] != MAGIC:
+            raise ValueError(f"{path} is not a columnar stats file")
+        (version,) = struct.unpack_from("=I", data, 8)
+        if version != VERSION:
+            raise ValueError(f"Unsupported columnar stats version {version}")
+
+        # Per schema: the stats and their offsets in the rows
+        self._schemas = {}
+        # Per row: its schema id and values, as views of the file
+        rows = []
+        ticks = []
+
+        pos = 12
+        while pos < len(data):
+            record, schema_id = struct.unpack_from("=II", data, pos)
+            pos += 8
+            if record == SCHEMA_RECORD:
+                schema, pos = self._read_schema(data, pos)
+                self._schemas[schema_id] = schema
+            elif record == ROW_RECORD:
+                tick, size = struct.unpack_from("=QQ", data, pos)
+                pos += 16
+                values = np.frombuffer(data, dtype="=f8", count=size,
+                                       offset=pos)
+                pos += 8 * size
+                rows.append((schema_id, values))
+                ticks.append(tick)
+            else:
+                raise ValueError(f"Corrupted record at offset {pos - 8}")
+
+        self.ticks = np.array(ticks, dtype=np.uint64)
+        self._rows = rows
+
+        self._infos = {}
+        for schema in self._schemas.values():
+            for info, _ in schema.values():
+                self._infos.setdefault(info.name, info)
+
+    @staticmethod
+    def _read_string(data, pos):
+        (length,) = struct.unpack_from("=I", data, pos)
+        pos += 4
+        return data[pos : pos + length].decode(), pos + length
+
+    def _read_schema(self, data, pos):
+        (num_stats,) = struct.unpack_from("=I", data, pos)
+        pos += 4
+        schema = {}
+        offset = 0
+        for _ in range(num_stats):
+            kind, size = struct.unpack_from("=II", data, pos)
+            pos += 8
+            name, pos = self._read_string(data, pos)
+            desc, pos = self._read_string(data, pos)
+            unit, pos = self._read_string(data, pos)
+            (num_subnames,) = struct.unpack_from("=I", data, pos)
+            pos += 4
+            subnames = []
+            for _ in range(num_subnames):
+                subname, pos = self._read_string(data, pos)
+                subnames.append(subname)
+            schema[name] = (
+                StatInfo(kind, size, name, desc, unit, subnames),
+                offset,
+            )
+            offset += size
+        return schema, pos
+
+    def names(self):
+        """The names of all the stats, in the order of the first dump."""
+        return list(self._infos)
+
+    def info(self, name):
+        """The kind, size, description, unit and subnames of a stat."""
+        return self._infos[name]
+
+    def __contains__(self, name):
+        return name in self._infos
+
+    def __len__(self):
+        return len(self._rows)
+
+    def __getitem__(self, name):
+        """
+        The values of a stat over all the dumps: a 1-D array for scalars,
+        and a 2-D array (dumps, values) otherwise.
+        """
+        info = self._infos[name]
+        values = np.full((len(self._rows), info.size), np.nan)
+
+        # Copy the rows of each schema at once
+        for schema_id, schema in self._schemas.items():
+            if name not in schema:
+                continue
+            schema_info, offset = schema[name]
+            if schema_info.size != info.size:
+                continue
+            indices = [
+                i for i, (row_schema, _) in enumerate(self._rows)
+                if row_schema == schema_id
+            ]
+            if indices:
+                values[indices] = np.stack(
+                    [self._rows[i][1][offset : offset + info.size]
+                     for i in indices]
+                )
+
+        if info.kind == "scalar":
+            return values[:, 0]
+        return values
+
+    def deltas(self, name):
+        """
+        The values of a stat over each interval, for files of snapshots
+        of stats that are never reset: the difference between each row
+        and the previous one (the first one is relative to zero). This
+        only makes sense for counters, not for, e.g., the minimum of a
+        distribution.
+        """
+        values = self[name]
+        return np.diff(values, axis=0, prepend=np.zeros_like(values[:1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Print the stats of a columnar stats file."
+    )
+    parser.add_argument("file", help="Columnar stats file")
+    parser.add_argument("stats", nargs="*",
+                        help="Stats to print as CSV, one column per value")
+    args = parser.parse_args()
+
+    stats = ColumnarStats(args.file)
+    if not args.stats:
+        for name in stats.names():
+            info = stats.info(name)
+            print(f"{name} ({info.kind}, {info.size} values)")
+        return
+
+    columns = [stats.ticks.astype(np.float64)[:, None]]
+    header = ["tick"]
+    for name in args.stats:
+        values = stats[name]
+        if values.ndim == 1:
+            values = values[:, None]
+            header.append(name)
+        else:
+            subnames = stats.info(name).subnames
+            header += [f"{name}::{s}" for s in subnames]
+        columns.append(values)
+
+    print(",".join(header))
+    np.savetxt(sys.stdout, np.hstack(columns), delimiter=",", fmt="%.17g")
+
+
+if __name__ == "__main__":
+    main()